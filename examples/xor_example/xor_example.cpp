@@ -7,14 +7,16 @@
 // 2-input XOR inputs and expected outputs.
 std::vector<std::vector<float>> xor_inputs = {{0.0, 0.0}, {0.0, 1.0}, {1.0, 0.0}, {1.0, 1.0}};
 std::vector<std::vector<float>> xor_outputs = {{0.0}, {1.0}, {1.0}, {0.0}};
+// The same inputs as one row-major batch so every genome is evaluated in a single pass
+std::vector<float> xor_batch = {0.0, 0.0, 0.0, 1.0, 1.0, 0.0, 1.0, 1.0};
 
 float eval_genomes(Genome_ptr g)
 {
     float fitness = 4.0;
+    std::vector<float> output = g->forward_batch(xor_batch, xor_inputs.size());
     for (int i = 0; i < xor_inputs.size(); i++)
     {
-        std::vector<float> output = g->forward(xor_inputs[i]);
-        fitness -= std::pow((output[0] - xor_outputs[i][0]), 2);
+        fitness -= std::pow((output[i] - xor_outputs[i][0]), 2);
     }
     return fitness;
 }
@@ -0,0 +1,25 @@
+#ifndef ACTIVATION_KERNELS_H
+#define ACTIVATION_KERNELS_H
+
+#include <cstddef>
+#include "activations.h"
+
+// Instruction sets the array-wide activation kernels can run with, from slowest to fastest
+enum class simd_level
+{
+    scalar,
+    sse,
+    avx2,
+    avx512
+};
+
+simd_level detect_simd_level();
+simd_level get_simd_level();
+bool simd_level_supported(simd_level level);
+
+void activate_array(valid_activations method, float *values, size_t n);
+void activate_array(valid_activations method, float *values, size_t n, simd_level level);
+void activate_array(valid_activations method, valid_precisions precision, float *values, size_t n);
+void activate_array(valid_activations method, valid_precisions precision, float *values, size_t n, simd_level level);
+
+#endif // ACTIVATION_KERNELS_H
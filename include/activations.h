@@ -4,6 +4,11 @@
 #include <map>
 #include <string>
 #include <cmath>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <vector>
 
 enum valid_activations
 {
@@ -56,6 +61,124 @@ inline float square_activation(float &x) { return std::pow(x, 2); }
 
 inline float cubed_activation(float &x) { return std::pow(x, 3); }
 
-float activate_value(float value, std::string method);
+// How closely sigmoid, tanh, gauss and softplus follow the std:: functions. The
+// other activations are cheap and always computed exactly.
+//  - exact: the std:: functions
+//  - fast:  polynomial approximations, max error
+//           sigmoid 1e-6, tanh 2e-6, softplus 1e-5 (absolute), gauss 2e-5 (relative)
+//  - lut:   linearly interpolated lookup tables, max error
+//           sigmoid 5e-6, tanh 1e-5, softplus 1e-5 (absolute), gauss 2e-5 (relative)
+// activate_array has SIMD kernels for every precision. fast is never slower than
+// exact there, lut mostly pays off without vector units since it needs gathers.
+enum class valid_precisions
+{
+    exact,
+    fast,
+    lut
+};
+
+static std::map<std::string, valid_precisions> precision_map = {
+    {"exact", valid_precisions::exact},
+    {"fast", valid_precisions::fast},
+    {"lut", valid_precisions::lut}};
+
+/**
+ * @brief 2^n for an exponent in the normal range [-126, 127]
+ */
+inline float pow2_int(int n) { return std::bit_cast<float>(static_cast<uint32_t>(n + 127) << 23); }
+
+/**
+ * @brief e^x within 4e-6 relative error, flushing to 0 where std::exp would produce a denormal
+ */
+inline float fast_exp(float x)
+{
+    // NaN has no exponent to split off
+    if (std::isnan(x))
+    {
+        return x;
+    }
+    if (x > 88.7228390F)
+    {
+        return std::numeric_limits<float>::infinity();
+    }
+    if (x < -87.3365447F)
+    {
+        return 0.0F;
+    }
+    // e^x = 2^n * 2^f with f in [0, 1), 2^f from a degree 4 polynomial
+    const float t = x * 1.44269504F;
+    const float n = std::floor(t);
+    const float f = t - n;
+    float p = 1.367030945e-02F;
+    p = p * f + 5.174499776e-02F;
+    p = p * f + 2.416043573e-01F;
+    p = p * f + 6.929729222e-01F;
+    p = p * f + 1.000003493e+00F;
+    // split the scale when 2^n itself would overflow
+    return (n > 127.0F) ? p * 2.0F * pow2_int(127) : p * pow2_int(static_cast<int>(n));
+}
+
+/**
+ * @brief log(1 + t) for t in [0, 1] within 6e-6 absolute error
+ */
+inline float fast_log1p_unit(float t)
+{
+    float p = -3.382204597e-02F;
+    p = p * t + 1.444710957e-01F;
+    p = p * t - 3.016380097e-01F;
+    p = p * t + 4.686588791e-01F;
+    p = p * t - 7.203587727e-01F;
+    p = p * t + 1.442681468e+00F;
+    // the polynomial is log2(1 + t) / t
+    return 0.693147181F * t * p;
+}
+
+inline float fast_sigmoid_activation(float &x) { return 1.0F / (1.0F + fast_exp(-x)); }
+
+inline float fast_tanh_activation(float &x) { return 1.0F - 2.0F / (fast_exp(2.0F * x) + 1.0F); }
+
+inline float fast_gauss_activation(float &x) { return fast_exp(x * x); }
+
+inline float fast_softplus_activation(float &x) { return std::max(x, 0.0F) + fast_log1p_unit(fast_exp(-std::fabs(x))); }
+
+/**
+ * @brief samples of a function on [low, high] that are linearly interpolated between
+ */
+class InterpolationTable
+{
+public:
+    float low;
+    float inv_step;
+    std::vector<float> samples;
+
+    InterpolationTable(double (*f)(double), float _low, float high, int num_steps);
+
+    // x must be within [low, high] or NaN
+    float lookup(float x) const
+    {
+        // NaN passes every range check and would index out of the table
+        if (std::isnan(x))
+        {
+            return x;
+        }
+        const float pos = (x - low) * inv_step;
+        const int i = std::min(static_cast<int>(pos), static_cast<int>(samples.size()) - 2);
+        return samples[i] + (pos - static_cast<float>(i)) * (samples[i + 1] - samples[i]);
+    }
+};
+
+const InterpolationTable &lut_table(valid_activations method);
+
+float lut_sigmoid_activation(float x);
+float lut_tanh_activation(float x);
+float lut_gauss_activation(float x);
+float lut_softplus_activation(float x);
+
+valid_activations to_activation(const std::string &method);
+std::string activation_name(valid_activations method);
+valid_precisions to_precision(const std::string &precision);
+float activate_value(float value, const std::string &method);
+float activate_value(float value, valid_activations method);
+float activate_value(float value, valid_activations method, valid_precisions precision);
 
 #endif // ACTIVATIONS_H
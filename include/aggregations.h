@@ -5,6 +5,8 @@
 #include <map>
 #include <vector>
 #include <numeric>
+#include <algorithm>
+#include <limits>
 
 enum class valid_aggregations
 {
@@ -22,13 +24,13 @@ static std::map<std::string, valid_aggregations> agg_map = {
     {"min", valid_aggregations::min},
     {"median", valid_aggregations::median}};
 
-inline float sum_aggregate(std::vector<float> &values) { return std::accumulate(values.begin(), values.end(), 0); }
+inline float sum_aggregate(const std::vector<float> &values) { return std::accumulate(values.begin(), values.end(), 0.0F); }
 
-inline float mean_aggregate(std::vector<float> &values) { return std::accumulate(values.begin(), values.end(), 0) / (float)values.size(); }
+inline float mean_aggregate(const std::vector<float> &values) { return std::accumulate(values.begin(), values.end(), 0.0F) / (float)values.size(); }
 
-inline float max_aggregate(std::vector<float> &values) { return *std::max_element(values.begin(), values.end()); }
+inline float max_aggregate(const std::vector<float> &values) { return *std::max_element(values.begin(), values.end()); }
 
-inline float min_aggregate(std::vector<float> &values) { return *std::min_element(values.begin(), values.end()); }
+inline float min_aggregate(const std::vector<float> &values) { return *std::min_element(values.begin(), values.end()); }
 
 inline float median_aggregate(std::vector<float> &values)
 {
@@ -44,6 +46,49 @@ inline float median_aggregate(std::vector<float> &values)
     }
 }
 
-float aggregate_vector(std::vector<float> values, std::string method);
+// Streaming form of the aggregations: values are folded into an accumulator as they arrive
+// instead of being gathered into a vector first. The median needs every value at once so it can't stream.
+inline bool is_streamable(valid_aggregations method) { return method != valid_aggregations::median; }
+
+inline float aggregate_identity(valid_aggregations method)
+{
+    switch (method)
+    {
+    case (valid_aggregations::max):
+        return -std::numeric_limits<float>::infinity();
+    case (valid_aggregations::min):
+        return std::numeric_limits<float>::infinity();
+    default:
+        return 0.0F;
+    }
+}
+
+inline float aggregate_fold(valid_aggregations method, float acc, float value)
+{
+    switch (method)
+    {
+    case (valid_aggregations::max):
+        return std::max(acc, value);
+    case (valid_aggregations::min):
+        return std::min(acc, value);
+    default:
+        return acc + value;
+    }
+}
+
+inline float aggregate_finish(valid_aggregations method, float acc, int count)
+{
+    // A node without any (enabled) inputs aggregates to nothing
+    if (count == 0)
+    {
+        return 0.0F;
+    }
+    return (method == valid_aggregations::mean) ? acc / static_cast<float>(count) : acc;
+}
+
+valid_aggregations to_aggregation(const std::string &method);
+std::string aggregation_name(valid_aggregations method);
+float aggregate_vector(const std::vector<float> &values, const std::string &method);
+float aggregate_vector(const std::vector<float> &values, valid_aggregations method);
 
 #endif // AGGREGATIONS_H
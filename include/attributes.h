@@ -3,8 +3,10 @@
 
 #include <string>
 #include <set>
+#include <vector>
 #include <random>
 #include <memory>
+#include <span>
 
 enum AttributeTypes
 {
@@ -17,17 +19,99 @@ constexpr float RAND_MAX_INV = 1.0F / static_cast<float>(RAND_MAX);
 static float rand_dec() { return static_cast<float>(rand()) * RAND_MAX_INV; }
 static bool rand_bool(float cutoff) { return (rand_dec() < cutoff); }
 
+typedef std::shared_ptr<const class OptionSet> OptionSet_ptr;
+
+/**
+ * @brief Sorted list of the options a StringAttribute can take
+ *
+ * Option sets are interned: every attribute created from equal options shares
+ * the same instance and only stores the index of its value, so attributes are
+ * copied, mutated and compared without touching any string.
+ */
+class OptionSet
+{
+public:
+    std::vector<std::string> options;
+
+    static OptionSet_ptr intern(const std::set<std::string> &_options);
+
+    OptionSet(const std::set<std::string> &_options);
+    int size() const;
+    const std::string &at(int id) const;
+    int id(const std::string &option) const;
+};
+
+typedef std::shared_ptr<const class AttributeSpec> AttributeSpec_ptr;
+
+/**
+ * @brief Parameters shared by every value of one kind of attribute
+ *
+ * How a value is initialized and mutated (distribution, rates and bounds) is the
+ * same for every gene carrying the attribute, so it lives once in a spec and the
+ * attributes themselves only hold their value. Numeric parameters are unused by
+ * bool and string specs, options are only used by string specs.
+ */
+class AttributeSpec
+{
+public:
+    AttributeTypes type;
+    std::string name;
+    float mean;
+    float stdev;
+    std::string init_type;
+    float mutate_rate;
+    float mutate_power;
+    float min_value;
+    float max_value;
+    OptionSet_ptr options;
+
+    // Constructors
+    AttributeSpec(AttributeTypes _type,
+                  const std::string &_name,
+                  float _mean,
+                  float _stdev,
+                  const std::string &_init_type,
+                  float _mutate_rate,
+                  float _mutate_power,
+                  float _min_value,
+                  float _max_value);
+    AttributeSpec(const std::string &_name,
+                  float _mutate_rate);
+    AttributeSpec(const std::string &_name,
+                  float _mutate_rate,
+                  OptionSet_ptr _options);
+
+    // values mutate_floats perturbs per pass, the noise of a pass is generated at once
+    static constexpr size_t mutate_batch = 64;
+    // below this mutate_rate mutate_floats only visits the values that mutate
+    static constexpr float sparse_mutate_rate = 0.2F;
+
+    // Values
+    float init_float() const;
+    float mutate_float(float value) const;
+    void mutate_floats(std::span<float> values) const;
+    int init_int() const;
+    int mutate_int(int value) const;
+    bool mutate_bool(bool value) const;
+    int init_option() const;
+    int mutate_option(int value_id) const;
+
+    std::string to_string() const;
+    bool validate() const;
+};
+
 typedef std::shared_ptr<class Attribute> Attribute_ptr;
 
 class Attribute
 {
 public:
-    std::string name;
+    AttributeSpec_ptr spec;
 
     // Overide Operators
-    bool operator<(const Attribute &other) const { return (name < other.name); };
+    bool operator<(const Attribute &other) const { return (spec->name < other.spec->name); };
 
     // Getters
+    const std::string &get_name() const { return spec->name; }
     virtual float get_float_value() = 0;
     virtual bool get_bool_value() = 0;
     virtual std::string get_string_value() = 0;
@@ -38,9 +122,6 @@ public:
     virtual void mutate_value() = 0;
     virtual std::string to_string() = 0;
     virtual bool validate() = 0;
-
-protected:
-    float mutate_rate;
 };
 
 typedef std::shared_ptr<class BoolAttribute> BoolAttribute_ptr;
@@ -57,6 +138,7 @@ public:
     BoolAttribute(const std::string &_name,
                   const bool &_default_value,
                   const float &_mutate_rate);
+    BoolAttribute(AttributeSpec_ptr _spec, bool _value);
 
     // Getters
     float get_float_value();
@@ -78,15 +160,6 @@ class IntAttribute : public Attribute
 public:
     int value;
 
-private:
-    float mean;
-    float stdev;
-    std::string init_type;
-    float mutate_power;
-    int min_value;
-    int max_value;
-    std::normal_distribution<float> distribution;
-
 public:
     // Constructors
     IntAttribute(const std::string &_name,
@@ -97,6 +170,8 @@ public:
                  const float &_mutate_power,
                  const int &_min_value,
                  const int &_max_value);
+    IntAttribute(AttributeSpec_ptr _spec);
+    IntAttribute(AttributeSpec_ptr _spec, int _value);
 
     // Getters
     float get_float_value();
@@ -121,15 +196,6 @@ class FloatAttribute : public Attribute
 public:
     float value;
 
-private:
-    float mean;
-    float stdev;
-    std::string init_type;
-    float mutate_power;
-    float min_value;
-    float max_value;
-    std::normal_distribution<float> distribution;
-
 public:
     // Constructors
     FloatAttribute(const std::string &_name,
@@ -140,6 +206,8 @@ public:
                    const float &_mutate_power,
                    const float &_min_value,
                    const float &_max_value);
+    FloatAttribute(AttributeSpec_ptr _spec);
+    FloatAttribute(AttributeSpec_ptr _spec, float _value);
     // Getters
     float get_float_value();
     bool get_bool_value();
@@ -161,29 +229,26 @@ typedef std::shared_ptr<class StringAttribute> StringAttribute_ptr;
 class StringAttribute : public Attribute
 {
 public:
-    std::string value;
-
-private:
-    std::set<std::string> options;
-    std::uniform_int_distribution<int> distribution;
+    // index of the value in the spec's options
+    int value_id;
 
 public:
     StringAttribute(
         const std::string &_name,
         const float &_mutate_rate,
         const std::set<std::string> &_options);
+    StringAttribute(AttributeSpec_ptr _spec);
+    StringAttribute(AttributeSpec_ptr _spec, int _value_id);
     float get_float_value();
     bool get_bool_value();
     std::string get_string_value();
     float get_mutate_rate();
-    std::set<std::string> get_options();
+    OptionSet_ptr get_options();
+    bool same_value(const StringAttribute &other) const;
 
     Attribute_ptr copy();
     void mutate_value();
     std::string to_string();
     bool validate();
-
-private:
-    std::string random_option();
 };
-#endif // ATTRIBUTES_H
\ No newline at end of file
+#endif // ATTRIBUTES_H
@@ -0,0 +1,54 @@
+#ifndef COMPILED_NETWORK_H
+#define COMPILED_NETWORK_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include "network.h"
+
+typedef std::shared_ptr<const class CompiledNetwork> CompiledNetwork_ptr;
+
+/**
+ * @brief Native code version of a FeedForwardNetwork
+ *
+ * The network is emitted as straight-line C++ with every weight, bias and
+ * activation inlined as a constant, compiled into a shared object with the
+ * system compiler and loaded with dlopen. Shared objects are cached in
+ * cache_dir under the hash of their source, the compiler and its flags, so the
+ * same network is only ever compiled once per compiler. New cache directories
+ * are private to the user, and a cache directory or library that anyone else
+ * could have written is refused before loading. The compiler command is
+ * split on whitespace and run without a shell. The generated code always
+ * computes the exact activations.
+ */
+class CompiledNetwork
+{
+private:
+    typedef void (*forward_function)(const float *inputs, float *outputs);
+
+    int num_inputs;
+    int num_outputs;
+    std::string library_path;
+    void *handle;
+    forward_function forward_fn;
+
+public:
+    CompiledNetwork(const FeedForwardNetwork &network);
+    CompiledNetwork(const FeedForwardNetwork &network, const std::string &cache_dir, const std::string &compiler);
+    ~CompiledNetwork();
+
+    CompiledNetwork(const CompiledNetwork &) = delete;
+    CompiledNetwork &operator=(const CompiledNetwork &) = delete;
+
+    int get_num_inputs() const;
+    int get_num_outputs() const;
+    std::string get_library_path() const;
+
+    std::vector<float> forward(std::vector<float> inputs) const;
+
+    static std::string generate_source(const FeedForwardNetwork &network);
+    static std::string default_cache_dir();
+    static std::string default_compiler();
+};
+
+#endif // COMPILED_NETWORK_H
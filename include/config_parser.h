@@ -28,6 +28,7 @@ class SpecialConfig
 public:
     template <class T>
     T get_value(const std::string _str);
+    bool has_value(const std::string _str);
     std::string to_string();
 
 protected:
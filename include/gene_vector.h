@@ -0,0 +1,547 @@
+#ifndef GENE_VECTOR_H
+#define GENE_VECTOR_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <span>
+#include <cstddef>
+#include <iterator>
+#include <functional>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+#include <memory_resource>
+#include <cstdint>
+
+/**
+ * @brief Genes stored by value, sorted by their key, in copy-on-write blocks
+ *
+ * The genes are split into contiguous blocks of up to 2 * block_size genes.
+ * Lookups are binary searches and traversals walk memory in order, so two
+ * genomes are compared or crossed over with a single merge of their vectors.
+ *
+ * Copies share their blocks. Genes are only reachable through const access,
+ * every modification goes through a method that first copies the block it
+ * touches if another vector still shares it. A child that inherits most of its
+ * genes unchanged from a parent (see assign_derived) only owns the blocks its
+ * crossover or mutations changed.
+ *
+ * Blocks are allocated from a memory resource (the heap by default, see
+ * GenomeArena) and only shared between vectors using the same resource.
+ *
+ * Every modification advances version(), so an owner can tell whether the genes
+ * may have changed since it last derived anything from them.
+ *
+ * @tparam Gene gene type with a public, ordered key member and operator==
+ */
+template <typename Gene>
+class GeneVector
+{
+public:
+    typedef decltype(Gene::key) key_type;
+    // target number of genes per block, blocks are split once they hold twice as many
+    static constexpr size_t block_size = 32;
+
+private:
+    typedef std::pmr::vector<Gene> Block;
+    typedef std::shared_ptr<Block> Block_ptr;
+
+public:
+    /**
+     * @brief Iterates the genes of all blocks in key order
+     */
+    class const_iterator
+    {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef Gene value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const Gene *pointer;
+        typedef const Gene &reference;
+
+        const_iterator() : block(nullptr), offset(0) {}
+        const_iterator(const Block_ptr *_block, size_t _offset) : block(_block), offset(_offset) {}
+
+        reference operator*() const { return (**block)[offset]; }
+        pointer operator->() const { return &(**block)[offset]; }
+        const_iterator &operator++()
+        {
+            if (++offset == (*block)->size())
+            {
+                block++;
+                offset = 0;
+            }
+            return *this;
+        }
+        const_iterator operator++(int)
+        {
+            const_iterator it = *this;
+            ++(*this);
+            return it;
+        }
+        const_iterator &operator--()
+        {
+            if (offset == 0)
+            {
+                block--;
+                offset = (*block)->size();
+            }
+            offset--;
+            return *this;
+        }
+        const_iterator operator--(int)
+        {
+            const_iterator it = *this;
+            --(*this);
+            return it;
+        }
+        // Skips whole blocks, linear in the number of blocks passed
+        const_iterator operator+(size_t n) const
+        {
+            const_iterator it = *this;
+            while (n)
+            {
+                size_t remaining = (*it.block)->size() - it.offset;
+                if (n < remaining)
+                {
+                    it.offset += n;
+                    break;
+                }
+                n -= remaining;
+                it.block++;
+                it.offset = 0;
+            }
+            return it;
+        }
+        bool operator==(const const_iterator &other) const { return block == other.block && offset == other.offset; }
+        bool operator!=(const const_iterator &other) const { return !(*this == other); }
+
+    private:
+        const Block_ptr *block;
+        size_t offset;
+
+        friend class GeneVector;
+    };
+    typedef const_iterator iterator;
+
+private:
+    std::pmr::memory_resource *resource;
+    std::pmr::vector<Block_ptr> blocks;
+    size_t num_genes;
+    uint64_t modifications;
+
+    static bool key_less(const Gene &gene, const key_type &key) { return gene.key < key; }
+
+    Block_ptr new_block() const
+    {
+        // the block picks up the resource through uses-allocator construction
+        return std::allocate_shared<Block>(std::pmr::polymorphic_allocator<Block>(resource));
+    }
+    /**
+     * @brief makes sure the block at index isn't shared before it is modified
+     *
+     * @param index
+     * @return Block&
+     */
+    Block &own_block(size_t index)
+    {
+        if (blocks[index].use_count() > 1)
+        {
+            Block_ptr copy = new_block();
+            copy->assign(blocks[index]->begin(), blocks[index]->end());
+            blocks[index] = copy;
+        }
+        return *blocks[index];
+    }
+    /**
+     * @brief index of the block that holds key, or would hold it if it were inserted
+     *
+     * @param key
+     * @return size_t
+     */
+    size_t block_index(const key_type &key) const
+    {
+        typename std::pmr::vector<Block_ptr>::const_iterator it =
+            std::lower_bound(blocks.begin(), blocks.end(), key, [](const Block_ptr &block, const key_type &k)
+                             { return block->back().key < k; });
+        if (it == blocks.end() && !blocks.empty())
+        {
+            it--;
+        }
+        return it - blocks.begin();
+    }
+    void copy_blocks(const GeneVector &other)
+    {
+        blocks.clear();
+        num_genes = other.num_genes;
+        if (resource == other.resource)
+        {
+            blocks.assign(other.blocks.begin(), other.blocks.end());
+            return;
+        }
+        blocks.reserve(other.blocks.size());
+        for (const Block_ptr &block : other.blocks)
+        {
+            blocks.push_back(new_block());
+            blocks.back()->assign(block->begin(), block->end());
+        }
+    }
+
+public:
+    GeneVector(std::pmr::memory_resource *_resource = std::pmr::get_default_resource())
+        : resource(_resource), blocks(_resource), num_genes(0), modifications(0) {}
+    // copies hold the same genes, so they start at the version of other
+    GeneVector(const GeneVector &other, std::pmr::memory_resource *_resource)
+        : resource(_resource), blocks(_resource), num_genes(0), modifications(other.modifications)
+    {
+        copy_blocks(other);
+    }
+    GeneVector(const GeneVector &other) : GeneVector(other, other.resource) {}
+    GeneVector &operator=(const GeneVector &other)
+    {
+        if (this != &other)
+        {
+            copy_blocks(other);
+            modifications++;
+        }
+        return *this;
+    }
+
+    const_iterator begin() const { return const_iterator(blocks.data(), 0); }
+    const_iterator end() const { return const_iterator(blocks.data() + blocks.size(), 0); }
+
+    size_t size() const { return num_genes; }
+    bool empty() const { return num_genes == 0; }
+    // only ever increases, changes with every call that may modify the genes
+    uint64_t version() const { return modifications; }
+    void clear()
+    {
+        blocks.clear();
+        num_genes = 0;
+        modifications++;
+    }
+    void reserve(size_t capacity) { blocks.reserve(capacity / block_size + 1); }
+    size_t num_blocks() const { return blocks.size(); }
+    /**
+     * @brief number of blocks of this vector that are shared with other
+     *
+     * @param other
+     * @return size_t
+     */
+    size_t shared_blocks(const GeneVector &other) const
+    {
+        size_t shared = 0;
+        for (const Block_ptr &block : blocks)
+        {
+            shared += std::count(other.blocks.begin(), other.blocks.end(), block);
+        }
+        return shared;
+    }
+
+    /**
+     * @brief replaces the stored genes with _genes, in any order
+     *
+     * @param _genes genes with unique keys
+     */
+    void assign(const std::vector<Gene> &_genes)
+    {
+        std::vector<Gene> sorted = _genes;
+        std::sort(sorted.begin(), sorted.end(), [](const Gene &a, const Gene &b)
+                  { return a.key < b.key; });
+        if (std::adjacent_find(sorted.begin(), sorted.end(), [](const Gene &a, const Gene &b)
+                               { return !(a.key < b.key); }) != sorted.end())
+        {
+            throw std::invalid_argument("Genes must have unique keys");
+        }
+        clear();
+        for (const Gene &gene : sorted)
+        {
+            push_back(gene);
+        }
+    }
+    /**
+     * @brief replaces the stored genes with derive(gene) for every gene of source
+     * Blocks of source whose genes derive leaves unchanged are shared instead of copied
+     *
+     * @tparam Derive callable const Gene & -> Gene that keeps the key
+     * @param source
+     * @param derive called exactly once per gene of source, in key order
+     */
+    template <typename Derive>
+    void assign_derived(const GeneVector &source, Derive derive)
+    {
+        clear();
+        blocks.reserve(source.blocks.size());
+        for (const Block_ptr &block : source.blocks)
+        {
+            Block_ptr derived = nullptr;
+            for (size_t i = 0; i < block->size(); i++)
+            {
+                Gene gene = derive((*block)[i]);
+                if (!derived && !(gene == (*block)[i]))
+                {
+                    // first change in this block, copy the genes derived so far
+                    derived = new_block();
+                    derived->reserve(block->size());
+                    derived->assign(block->begin(), block->begin() + i);
+                }
+                if (derived)
+                {
+                    derived->push_back(gene);
+                }
+            }
+            if (derived)
+            {
+                blocks.push_back(derived);
+            }
+            else if (resource == source.resource)
+            {
+                blocks.push_back(block);
+            }
+            else
+            {
+                blocks.push_back(new_block());
+                blocks.back()->assign(block->begin(), block->end());
+            }
+            num_genes += block->size();
+        }
+    }
+    /**
+     * @brief appends a gene whose key is greater than every stored key
+     * Used to build the vector in order (e.g. while merging two sorted vectors) without searching
+     *
+     * @param gene
+     */
+    void push_back(const Gene &gene)
+    {
+        if (!blocks.empty() && !(blocks.back()->back().key < gene.key))
+        {
+            throw std::invalid_argument("Genes must be appended in increasing key order");
+        }
+        if (blocks.empty() || blocks.back()->size() >= block_size)
+        {
+            blocks.push_back(new_block());
+            blocks.back()->reserve(block_size);
+        }
+        own_block(blocks.size() - 1).push_back(gene);
+        num_genes++;
+        modifications++;
+    }
+    /**
+     * @brief inserts gene at its sorted position, replacing the gene with the same key if there is one
+     *
+     * @param gene
+     * @return const Gene& the stored gene
+     */
+    const Gene &insert(const Gene &gene)
+    {
+        modifications++;
+        if (blocks.empty())
+        {
+            push_back(gene);
+            return blocks.back()->back();
+        }
+        size_t index = block_index(gene.key);
+        Block &block = own_block(index);
+        typename Block::iterator it = std::lower_bound(block.begin(), block.end(), gene.key, key_less);
+        if (it != block.end() && !(gene.key < it->key))
+        {
+            *it = gene;
+            return *it;
+        }
+        size_t position = it - block.begin();
+        block.insert(it, gene);
+        num_genes++;
+        if (block.size() >= 2 * block_size)
+        {
+            // split full blocks so a later copy on write stays small
+            Block_ptr upper = new_block();
+            upper->assign(block.begin() + block_size, block.end());
+            block.erase(block.begin() + block_size, block.end());
+            blocks.insert(blocks.begin() + index + 1, upper);
+            if (position >= block_size)
+            {
+                return (*upper)[position - block_size];
+            }
+        }
+        return (*blocks[index])[position];
+    }
+    /**
+     * @brief finds the gene with key
+     *
+     * @param key
+     * @return const_iterator the gene or end() if there is none
+     */
+    const_iterator find(const key_type &key) const
+    {
+        if (blocks.empty())
+        {
+            return end();
+        }
+        size_t index = block_index(key);
+        const Block &block = *blocks[index];
+        typename Block::const_iterator it = std::lower_bound(block.begin(), block.end(), key, key_less);
+        if (it == block.end() || key < it->key)
+        {
+            return end();
+        }
+        return const_iterator(blocks.data() + index, it - block.begin());
+    }
+    size_t count(const key_type &key) const { return find(key) != end() ? 1 : 0; }
+    /**
+     * @brief finds the first gene whose key is not less than key
+     *
+     * @param key
+     * @return const_iterator the gene or end() if every key is less
+     */
+    const_iterator lower_bound(const key_type &key) const
+    {
+        if (blocks.empty())
+        {
+            return end();
+        }
+        size_t index = block_index(key);
+        const Block &block = *blocks[index];
+        size_t offset = std::lower_bound(block.begin(), block.end(), key, key_less) - block.begin();
+        if (offset == block.size())
+        {
+            // only happens in the last block, every key is less
+            return end();
+        }
+        return const_iterator(blocks.data() + index, offset);
+    }
+    /**
+     * @brief gets the gene with key
+     *
+     * @param key
+     * @return const Gene&
+     */
+    const Gene &at(const key_type &key) const
+    {
+        const_iterator it = find(key);
+        if (it == end())
+        {
+            throw std::invalid_argument("Could not find gene in GeneVector");
+        }
+        return *it;
+    }
+    /**
+     * @brief applies update to the gene with key, update must not change the key
+     *
+     * @tparam Update callable Gene & -> void
+     * @param key
+     * @param update
+     */
+    template <typename Update>
+    void update(const key_type &key, Update update)
+    {
+        const_iterator it = find(key);
+        if (it == end())
+        {
+            throw std::invalid_argument("Could not find gene in GeneVector");
+        }
+        modifications++;
+        update(own_block(it.block - blocks.data())[it.offset]);
+    }
+    /**
+     * @brief applies update to every block of genes, update must not change the keys
+     * Lets a kernel process contiguous genes at once. Shared blocks are updated in a
+     * copy that only replaces the block if update changed one of its genes
+     *
+     * @tparam Update callable std::span<Gene> -> void
+     * @param update called exactly once per block in key order
+     */
+    template <typename Update>
+    void update_blocks(Update update)
+    {
+        modifications++;
+        std::vector<Gene> scratch;
+        for (size_t index = 0; index < blocks.size(); index++)
+        {
+            if (blocks[index].use_count() == 1)
+            {
+                update(std::span<Gene>(*blocks[index]));
+                continue;
+            }
+            const Block &shared = *blocks[index];
+            scratch.assign(shared.begin(), shared.end());
+            update(std::span<Gene>(scratch));
+            if (!std::equal(scratch.begin(), scratch.end(), shared.begin()))
+            {
+                Block_ptr copy = new_block();
+                copy->assign(scratch.begin(), scratch.end());
+                blocks[index] = copy;
+            }
+        }
+    }
+    /**
+     * @brief removes the gene with key
+     *
+     * @param key
+     * @return size_t number of removed genes (0 or 1)
+     */
+    size_t erase(const key_type &key)
+    {
+        const_iterator it = find(key);
+        if (it == end())
+        {
+            return 0;
+        }
+        size_t index = it.block - blocks.data();
+        Block &block = own_block(index);
+        block.erase(block.begin() + it.offset);
+        modifications++;
+        if (block.empty())
+        {
+            blocks.erase(blocks.begin() + index);
+        }
+        num_genes--;
+        return 1;
+    }
+    /**
+     * @brief removes every gene matching predicate in a single pass
+     * Blocks without a matching gene stay shared
+     *
+     * @param predicate called exactly once per gene in key order
+     * @return size_t number of removed genes
+     */
+    template <typename Predicate>
+    size_t erase_if(Predicate predicate)
+    {
+        size_t removed = 0;
+        for (size_t index = 0; index < blocks.size();)
+        {
+            typename Block::const_iterator first = std::find_if(blocks[index]->cbegin(), blocks[index]->cend(), std::ref(predicate));
+            if (first == blocks[index]->cend())
+            {
+                index++;
+                continue;
+            }
+            size_t write = first - blocks[index]->cbegin();
+            Block &block = own_block(index);
+            for (size_t read = write + 1; read < block.size(); read++)
+            {
+                if (!predicate(block[read]))
+                {
+                    block[write++] = block[read];
+                }
+            }
+            removed += block.size() - write;
+            block.erase(block.begin() + write, block.end());
+            if (block.empty())
+            {
+                blocks.erase(blocks.begin() + index);
+            }
+            else
+            {
+                index++;
+            }
+        }
+        num_genes -= removed;
+        modifications++;
+        return removed;
+    }
+};
+
+#endif // GENE_VECTOR_H
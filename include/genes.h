@@ -1,72 +1,62 @@
 #ifndef GENES_H
 #define GENES_H
 
-#include <map>
-#include <vector>
+#include <span>
+#include <string>
 #include <utility>
-#include <memory>
-#include "attributes.h"
-
-typedef std::shared_ptr<class Gene> Gene_ptr;
-
-class Gene
-{
-public:
-    // Public Variables
-    std::map<std::string, Attribute_ptr> attributes;
-
-    // Member Function Declaration
-    bool has_attribute(std::string _key);
-    Attribute_ptr get_attribute(std::string _key);
-    void mutate();
-    std::string to_string();
-
-protected:
-    bool verify_ind_attribute(std::string _key, std::string _type);
-    bool verify_ind_attribute(std::string _key, std::vector<std::string> _types);
-    virtual void verify_attributes() = 0;
-
-    std::map<std::string, AttributeTypes> type_map = {
-        {"FloatAttribute", AttributeTypes::float_attribute},
-        {"IntAttribute", AttributeTypes::int_attribute},
-        {"BoolAttribute", AttributeTypes::bool_attribute},
-        {"StringAttribute", AttributeTypes::string_attribute}};
-};
-
-typedef std::shared_ptr<class NodeGene> NodeGene_ptr;
-
-class NodeGene : public Gene
+#include "activations.h"
+#include "aggregations.h"
+
+// Genes read their initialization and mutation parameters from the config shared by the genome
+class GenomeConfig;
+
+/**
+ * @brief Plain data node gene, the parameters every node gene is initialized and
+ * mutated with live once in the GenomeConfig instead of in every gene.
+ * Genomes keep their genes by value, see GeneVector
+ */
+class NodeGene
 {
 public:
     int key;
-    bool operator<(const NodeGene_ptr other) { return this->key < other->key; }
-    NodeGene(int _key, std::vector<Attribute_ptr> _attributes);
-    float distance(NodeGene_ptr &other, float compatability_weight = 1.0F);
-    NodeGene_ptr copy();
-    NodeGene_ptr crossover(NodeGene_ptr &gene2);
-    std::string to_string();
-
-private:
-    void verify_attributes();
+    float bias;
+    float response;
+    float time_constant;
+    valid_activations activation;
+    valid_aggregations aggregation;
+
+    bool operator<(const NodeGene &other) const { return this->key < other.key; }
+    bool operator==(const NodeGene &other) const = default;
+    NodeGene(int _key, float _bias, float _response, valid_activations _activation, valid_aggregations _aggregation, float _time_constant = 1.0F);
+    NodeGene(int _key, const GenomeConfig &config);
+    float distance(const NodeGene &other, float compatability_weight = 1.0F) const;
+    NodeGene crossover(const NodeGene &gene2) const;
+    void mutate(const GenomeConfig &config);
+    static void mutate_all(std::span<NodeGene> genes, const GenomeConfig &config);
+    std::string to_string() const;
 };
 
-typedef std::shared_ptr<class ConnectionGene> ConnectionGene_ptr;
-
-class ConnectionGene : public Gene
+/**
+ * @brief Plain data connection gene, see NodeGene
+ */
+class ConnectionGene
 {
 public:
     std::pair<int, int> key;
-    bool operator<(const ConnectionGene_ptr other) { return std::abs(this->key.first + this->key.second) < std::abs(other->key.first + other->key.second); }
-    ConnectionGene(std::pair<int, int> _key, std::vector<Attribute_ptr> _attributes);
-    float distance(ConnectionGene_ptr &other, float compatability_weight = 1.0F);
-    ConnectionGene_ptr copy();
-    ConnectionGene_ptr crossover(ConnectionGene_ptr &gene2);
-    std::string to_string();
+    float weight;
+    bool enabled;
+
+    bool operator<(const ConnectionGene &other) const { return this->key < other.key; }
+    bool operator==(const ConnectionGene &other) const = default;
+    ConnectionGene(std::pair<int, int> _key, float _weight, bool _enabled = true);
+    ConnectionGene(std::pair<int, int> _key, const GenomeConfig &config);
+    float distance(const ConnectionGene &other, float compatability_weight = 1.0F) const;
+    ConnectionGene crossover(const ConnectionGene &gene2) const;
+    void mutate(const GenomeConfig &config);
+    static void mutate_all(std::span<ConnectionGene> genes, const GenomeConfig &config);
+    std::string to_string() const;
     void disable();
     void enable();
-
-private:
-    void verify_attributes();
 };
 
-#endif // GENES_H
\ No newline at end of file
+#endif // GENES_H
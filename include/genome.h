@@ -2,13 +2,23 @@
 #define GENOME_H
 
 #include <map>
+#include <cstdint>
 #include <string>
 #include <vector>
+#include <span>
 #include <set>
+#include <unordered_map>
+#include <memory_resource>
 #include "genes.h"
+#include "attributes.h"
+#include "gene_vector.h"
+#include "innovation_tracker.h"
+#include "network.h"
 #include "config_parser.h"
 
-typedef std::shared_ptr<class GenomeConfig> GenomeConfig_ptr;
+// Genomes share one config that is parsed and validated once. Its parameters are never modified
+// afterwards, only the innovation tracker it points to changes as genomes mutate
+typedef std::shared_ptr<const class GenomeConfig> GenomeConfig_ptr;
 
 class GenomeConfig : SpecialConfig
 {
@@ -47,16 +57,29 @@ public:
     float response_mutate_rate;
     float response_replace_rate;
 
+    float time_constant_init_mean;
+    float time_constant_init_stdev;
+    std::string time_constant_init_type;
+    float time_constant_max_value;
+    float time_constant_min_value;
+    float time_constant_mutate_power;
+    float time_constant_mutate_rate;
+    float time_constant_replace_rate;
+
     // Connection Parameters
+    bool feed_forward;
     std::string initial_connection;
 
     std::string activation_default;
     float activation_mutate_rate;
     std::set<std::string> activation_options;
+    std::vector<valid_activations> activation_ids;
+    valid_precisions activation_precision;
 
     std::string aggregation_default;
     float aggregation_mutate_rate;
     std::set<std::string> aggregation_options;
+    std::vector<valid_aggregations> aggregation_ids;
 
     bool enabled_default;
     float enabled_mutate_rate;
@@ -72,6 +95,15 @@ public:
     float weight_mutate_rate;
     float weight_replace_rate;
 
+    // Shared init and mutation parameters of the float gene values
+    AttributeSpec_ptr bias_spec;
+    AttributeSpec_ptr response_spec;
+    AttributeSpec_ptr time_constant_spec;
+    AttributeSpec_ptr weight_spec;
+
+    // Node keys of structural mutations, the only state genomes share that changes
+    InnovationTracker_ptr innovation_tracker;
+
     // Mutation Parameters
 
     GenomeConfig(ConfigParser_ptr _config);
@@ -85,24 +117,57 @@ public:
     int key;
     float fitness;
 
-    std::map<std::pair<int, int>, ConnectionGene_ptr> connections;
-    std::map<int, NodeGene_ptr> nodes;
+    // genes sorted by key, see GeneVector
+    GeneVector<ConnectionGene> connections;
+    GeneVector<NodeGene> nodes;
 
 private:
+    // random pairs mutate_add_conn draws before it enumerates every possible connection
+    static constexpr int add_conn_attempts = 32;
+    // larger feed forward genomes search the topological order instead of keeping a reachability matrix
+    static constexpr size_t max_reachability_nodes = 2048;
+
     GenomeConfig_ptr config;
 
     std::set<int> input_keys;
     std::set<int> output_keys;
     std::set<int> hidden_keys;
 
-    std::vector<int> forward_order;
-    std::map<int, std::set<int>> node_inputs_map;
+    std::vector<std::vector<int>> forward_levels;
+    // (out, in) key of every connection sorted by out, so the inputs of a node are one
+    // contiguous range. The outputs of a node are one range of the connections themselves
+    std::pmr::vector<std::pair<int, int>> input_edges;
+    // (key, position) of every node in a topological order over every connection, sorted by key.
+    // Kept up to date as connections are added, only meaningful for feed forward genomes
+    std::pmr::vector<std::pair<int, int>> node_order;
+    int next_order;
+    // transitive closure of a feed forward genome over every connection, bit j of row i is set if the
+    // node in slot i reaches the node in slot j (slots index node_order). Grown as connections are added,
+    // built again on demand after a node is added or a node or connection is removed
+    std::vector<uint64_t> reachability;
+    size_t reachability_words;
+    bool reachability_valid;
+    FeedForwardNetwork_ptr network;
+    RecurrentNetwork_ptr recurrent_network;
     bool activated;
+    // (nodes, connections) versions the key sets, input_edges and node_order were last derived from and
+    // the versions the network was last compiled from. Differing versions mean the public gene vectors
+    // were modified directly since
+    std::pair<uint64_t, uint64_t> indexed_versions;
+    std::pair<uint64_t, uint64_t> activated_versions;
 
 public:
     // Constructor
-    Genome(int _key, ConfigParser_ptr _config);
-    Genome(int _key, Genome_ptr &g1, Genome_ptr &g2, ConfigParser_ptr _config);
+    Genome(int _key, GenomeConfig_ptr _config, std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+    Genome(int _key, Genome_ptr &g1, Genome_ptr &g2, GenomeConfig_ptr _config, std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+    // Standalone genomes parse their config and start an innovation history of their own
+    Genome(int _key, ConfigParser_ptr _config, std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+    Genome(int _key, Genome_ptr &g1, Genome_ptr &g2, ConfigParser_ptr _config, std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+    Genome(const Genome &other, std::pmr::memory_resource *resource);
+    // A plain copy would point into the memory resource of other without keeping its arena alive,
+    // copies always name their resource instead
+    Genome(const Genome &) = delete;
+    Genome &operator=(const Genome &) = delete;
 
     int get_num_inputs();
     int get_num_outputs();
@@ -113,19 +178,44 @@ public:
     void mutate();
     void activate();
     float distance(Genome_ptr &other);
-    std::vector<float> forward(std::vector<float> inputs);
+    std::vector<float> forward(const std::vector<float> &inputs);
+    void forward(std::span<const float> inputs, std::span<float> outputs);
+    std::vector<float> forward_batch(const std::vector<float> &inputs, int batch_size);
+    FeedForwardNetwork_ptr get_network();
+    RecurrentNetwork_ptr get_recurrent_network();
+    CTRNN_ptr create_ctrnn(ctrnn_integrator integrator = ctrnn_integrator::euler);
+    void reset();
 
     std::string to_string();
+    bool reaches(int from_key, int to_key);
+    bool reaches_output(int node_key);
 
 private:
-    NodeGene_ptr new_node(int node_key);
-    ConnectionGene_ptr new_connection(std::pair<int, int> connection_key);
+    NodeGene new_node(int node_key);
+    ConnectionGene new_connection(std::pair<int, int> connection_key);
     void generate_full_connections(bool direct, std::vector<std::pair<int, int>> &connections);
-    void generate_node_inputs();
+    std::span<const std::pair<int, int>> get_input_edges(int node_key) const;
+    GeneVector<ConnectionGene>::const_iterator get_output_edges(int node_key) const;
+    std::pair<int, int> random_connection() const;
+    void add_connection(std::pair<int, int> conn_key);
+    void delete_connection(std::pair<int, int> conn_key);
+    void add_hidden_node(int node_key);
+    int get_order(int node_key) const;
+    void set_order(int node_key, int order);
+    void update_order(std::pair<int, int> conn);
+    std::pair<uint64_t, uint64_t> gene_versions() const;
+    void rebuild_index();
+    void compile_network();
+    void compile_recurrent_network();
+    std::vector<std::pair<valid_activations, int>> order_recurrent_nodes(std::unordered_map<int, int> &dense_index);
     void mutate_add_node();
     void mutate_delete_node();
     void mutate_add_conn();
     void mutate_delete_conn();
+    size_t get_slot(int node_key) const;
+    bool use_reachability();
+    void build_reachability();
+    bool is_possible_connection(std::pair<int, int> conn_key);
     bool creates_cycle(std::pair<int, int> conn);
 };
 
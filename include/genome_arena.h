@@ -0,0 +1,84 @@
+#ifndef GENOME_ARENA_H
+#define GENOME_ARENA_H
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <utility>
+#include <memory_resource>
+#include "genome.h"
+
+typedef std::shared_ptr<class GenomeArena> GenomeArena_ptr;
+
+/**
+ * @brief Bump allocator backing one generation of genomes and their genes
+ *
+ * Memory is handed out from large slabs by advancing an offset, individual
+ * deallocations are ignored. Once no genome allocated from the arena is alive
+ * anymore reset() recycles every slab at once, so later generations reuse the
+ * same memory instead of returning to the heap for each genome and gene vector.
+ * Not thread safe, a generation is built by a single thread.
+ */
+class GenomeArena : public std::pmr::memory_resource
+{
+private:
+    std::vector<std::pair<std::unique_ptr<std::byte[]>, size_t>> slabs;
+    size_t slab_size;
+    size_t current_slab;
+    size_t offset;
+    size_t allocated;
+
+public:
+    GenomeArena(size_t _slab_size = 1 << 16);
+
+    void reset();
+    size_t bytes_allocated() const;
+    size_t bytes_reserved() const;
+
+protected:
+    void *do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void *p, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override;
+};
+
+/**
+ * @brief Allocator for std::allocate_shared that keeps its arena alive
+ * The shared_ptr control block stores a copy, so the arena can't be reset or
+ * destroyed while any genome allocated from it is still referenced (e.g. an elite
+ * or the best genome held by the caller)
+ *
+ * @tparam T
+ */
+template <typename T>
+class ArenaAllocator
+{
+public:
+    typedef T value_type;
+    GenomeArena_ptr arena;
+
+    ArenaAllocator(GenomeArena_ptr _arena) : arena(std::move(_arena)) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) : arena(other.arena) {}
+
+    T *allocate(size_t n) { return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T))); }
+    void deallocate(T *p, size_t n) { arena->deallocate(p, n * sizeof(T), alignof(T)); }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U> &other) const { return arena == other.arena; }
+};
+
+/**
+ * @brief Creates a genome whose object and gene vectors are allocated from arena
+ *
+ * @tparam Args Genome constructor arguments, the memory resource is appended
+ * @param arena
+ * @param args
+ * @return Genome_ptr
+ */
+template <typename... Args>
+Genome_ptr make_arena_genome(const GenomeArena_ptr &arena, Args &&...args)
+{
+    return std::allocate_shared<Genome>(ArenaAllocator<Genome>(arena), std::forward<Args>(args)..., arena.get());
+}
+
+#endif // GENOME_ARENA_H
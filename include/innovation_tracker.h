@@ -0,0 +1,47 @@
+#ifndef INNOVATION_TRACKER_H
+#define INNOVATION_TRACKER_H
+
+#include <map>
+#include <mutex>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <utility>
+
+typedef std::shared_ptr<class InnovationTracker> InnovationTracker_ptr;
+
+/**
+ * @brief Population wide registry of structural innovations
+ *
+ * Hands out node keys that are unique across the whole population. Splitting
+ * the same connection in different genomes during one generation yields the
+ * same node key, so identical innovations stay homologous and line up in
+ * crossover and distance. Connections are keyed by the nodes they join, so
+ * identical connections already share their key.
+ *
+ * The split registry is sharded by connection, each shard has its own lock and
+ * new keys come from an atomic counter, so genomes can mutate in parallel.
+ */
+class InnovationTracker
+{
+public:
+    static constexpr size_t num_shards = 16;
+
+private:
+    struct Shard
+    {
+        std::mutex mutex;
+        std::map<std::pair<int, int>, int> split_nodes;
+    };
+    std::array<Shard, num_shards> shards;
+    std::atomic<int> next_node_key;
+
+public:
+    InnovationTracker(int first_node_key);
+
+    int new_node_key();
+    int split_node_key(std::pair<int, int> connection);
+    void next_generation();
+};
+
+#endif // INNOVATION_TRACKER_H
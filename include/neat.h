@@ -1,2 +1,3 @@
 #include "population.h"
-#include "config_parser.h"
\ No newline at end of file
+#include "config_parser.h"
+#include "compiled_network.h"
\ No newline at end of file
@@ -0,0 +1,199 @@
+#ifndef NETWORK_H
+#define NETWORK_H
+
+#include <vector>
+#include <span>
+#include <memory>
+#include "activations.h"
+#include "aggregations.h"
+
+typedef std::shared_ptr<const class FeedForwardNetwork> FeedForwardNetwork_ptr;
+
+/**
+ * @brief Immutable, flattened form of an activated Genome
+ *
+ * Every node that takes part in the computation is given a dense index. The
+ * network inputs occupy indices [0, num_inputs) and every evaluated node
+ * follows in the order it must be computed, so evaluation is a single pass
+ * over contiguous arrays. The incoming edges of each evaluated node are stored
+ * in CSR form: the edges of evaluated node i are in
+ * [edge_offsets[i], edge_offsets[i + 1]) of edge_sources/edge_weights.
+ *
+ * Evaluated nodes are grouped into topological levels, level l holds evaluated
+ * nodes [level_offsets[l], level_offsets[l + 1]) and only reads nodes of earlier
+ * levels, so every node of a level can be computed at once.
+ */
+class FeedForwardNetwork
+{
+public:
+    int num_inputs;
+    int num_outputs;
+    int num_nodes;
+    valid_precisions precision;
+
+    // Per evaluated node data (index i refers to dense node num_inputs + i)
+    std::vector<float> node_bias;
+    std::vector<float> node_response;
+    std::vector<valid_activations> node_activation;
+    std::vector<valid_aggregations> node_aggregation;
+
+    // CSR incoming edges of every evaluated node
+    std::vector<int> edge_offsets;
+    std::vector<int> edge_sources;
+    std::vector<float> edge_weights;
+
+    // Evaluated node boundaries of every level
+    std::vector<int> level_offsets;
+
+    // Dense index of every output in output key order
+    std::vector<int> output_indices;
+
+public:
+    FeedForwardNetwork(int _num_inputs, valid_precisions _precision = valid_precisions::exact);
+
+    int get_num_evaluated();
+    int get_num_levels() const;
+    void add_level();
+    int add_node(float bias, float response, valid_activations activation, valid_aggregations aggregation);
+    void add_edge(int source, float weight);
+    void add_output(int node_index);
+
+    std::vector<float> forward(const std::vector<float> &inputs) const;
+    void forward(std::span<const float> inputs, std::span<float> outputs) const;
+    std::vector<float> forward_batch(const std::vector<float> &inputs, int batch_size) const;
+
+private:
+    void activate_level(float *level_values, int first, int last) const;
+};
+
+typedef std::shared_ptr<class RecurrentNetwork> RecurrentNetwork_ptr;
+
+/**
+ * @brief Flattened form of an activated recurrent Genome
+ *
+ * Uses the same dense indices and CSR incoming edges as FeedForwardNetwork,
+ * but an edge may come from any node, including itself. Every call advances
+ * all nodes by one synchronous step in which each node reads the values its
+ * sources had after the previous step, so the node values are persistent
+ * state until reset is called. The state of several independent sequences
+ * can be advanced at once with forward_batch.
+ */
+class RecurrentNetwork
+{
+public:
+    int num_inputs;
+    int num_outputs;
+    int num_nodes;
+    valid_precisions precision;
+
+    // Per evaluated node data (index i refers to dense node num_inputs + i)
+    std::vector<float> node_bias;
+    std::vector<float> node_response;
+    std::vector<valid_activations> node_activation;
+    std::vector<valid_aggregations> node_aggregation;
+
+    // CSR incoming edges of every evaluated node
+    std::vector<int> edge_offsets;
+    std::vector<int> edge_sources;
+    std::vector<float> edge_weights;
+
+    // Dense index of every output in output key order
+    std::vector<int> output_indices;
+
+private:
+    // Node-major state, the sequences of node n are stored in [n * batch_size, (n + 1) * batch_size)
+    int batch_size;
+    std::vector<float> values;
+    std::vector<float> next_values;
+    std::vector<float> agg_vec;
+
+public:
+    RecurrentNetwork(int _num_inputs, int _num_evaluated, valid_precisions _precision = valid_precisions::exact);
+
+    int get_num_evaluated() const;
+    int get_batch_size() const;
+    int add_node(float bias, float response, valid_activations activation, valid_aggregations aggregation);
+    void add_edge(int source, float weight);
+    void add_output(int node_index);
+
+    void reset();
+    std::vector<float> forward(const std::vector<float> &inputs);
+    void forward(std::span<const float> inputs, std::span<float> outputs);
+    std::vector<float> forward_batch(const std::vector<float> &inputs, int _batch_size);
+
+private:
+    void step();
+};
+
+// Fixed step integrators a CTRNN can advance its state with
+enum class ctrnn_integrator
+{
+    euler,
+    rk4
+};
+
+typedef std::shared_ptr<class CTRNN> CTRNN_ptr;
+
+/**
+ * @brief Continuous-time recurrent network
+ *
+ * Uses the same dense indices and CSR edge lists as RecurrentNetwork. The state y
+ * of every evaluated node follows
+ *      dy/dt = (activation(bias + response * aggregation(w * y_source)) - y) / time_constant
+ * with the inputs held constant, and is integrated with fixed steps over all nodes
+ * at once. The outputs are the states of the output nodes.
+ */
+class CTRNN
+{
+public:
+    int num_inputs;
+    int num_outputs;
+    int num_nodes;
+    ctrnn_integrator integrator;
+    valid_precisions precision;
+
+    // Per evaluated node data (index i refers to dense node num_inputs + i)
+    std::vector<float> node_bias;
+    std::vector<float> node_response;
+    std::vector<float> node_time_constant;
+    std::vector<valid_activations> node_activation;
+    std::vector<valid_aggregations> node_aggregation;
+
+    // CSR incoming edges of every evaluated node
+    std::vector<int> edge_offsets;
+    std::vector<int> edge_sources;
+    std::vector<float> edge_weights;
+
+    // Dense index of every output in output key order
+    std::vector<int> output_indices;
+
+private:
+    std::vector<float> node_inv_time_constant;
+    // State of every node (inputs included) and the integrator stages
+    std::vector<float> state;
+    std::vector<float> stage;
+    std::vector<float> k1;
+    std::vector<float> k2;
+    std::vector<float> k3;
+    std::vector<float> k4;
+    std::vector<float> agg_vec;
+
+public:
+    CTRNN(int _num_inputs, int _num_evaluated, ctrnn_integrator _integrator = ctrnn_integrator::euler,
+          valid_precisions _precision = valid_precisions::exact);
+
+    int get_num_evaluated() const;
+    int add_node(float bias, float response, float time_constant, valid_activations activation, valid_aggregations aggregation);
+    void add_edge(int source, float weight);
+    void add_output(int node_index);
+
+    void reset();
+    std::vector<float> get_state() const;
+    std::vector<float> advance(const std::vector<float> &inputs, float dt, int steps);
+    void advance(std::span<const float> inputs, std::span<float> outputs, float dt, int steps);
+
+private:
+    void derivative(const float *y, float *dydt);
+};
+
+#endif // NETWORK_H
@@ -7,7 +7,9 @@
 #include <functional>
 
 #include "genome.h"
+#include "genome_arena.h"
 #include "species.h"
+#include "aggregations.h"
 #include "config_parser.h"
 
 typedef std::shared_ptr<class PopulationConfig> PopulationConfig_ptr;
@@ -16,19 +18,22 @@ class PopulationConfig : SpecialConfig
 {
 public:
     // Population Runtime Config
-    std::string fitness_criterion;
+    valid_aggregations fitness_criterion;
     float fitness_threshold;
     int pop_size;
     bool reset_on_extinction;
     bool no_fitness_termination;
+    bool genome_arena;
     // Stagnation Config
-    std::string species_fitness_func;
+    valid_aggregations species_fitness_func;
     int max_stagnation;
     int species_elitism;
     // Reproduction Config
     int elitism;
     float survival_threshold;
     int min_species_size;
+    // Parsed once and shared by every genome
+    GenomeConfig_ptr genome_config;
 
     PopulationConfig(ConfigParser_ptr _config);
 };
@@ -47,6 +52,8 @@ private:
     int total_genomes;
     SpeciesSet_ptr species_set;
     std::map<int, Genome_ptr> population;
+    // arenas of the generations that may still be referenced, only used with genome_arena
+    std::vector<GenomeArena_ptr> arenas;
 
 public:
     Population(ConfigParser_ptr _config);
@@ -57,10 +64,11 @@ public:
 #else
 private:
 #endif
-    std::map<int, Genome_ptr> new_population(ConfigParser_ptr _config, int pop_size);
+    std::map<int, Genome_ptr> new_population(GenomeConfig_ptr _config, int pop_size);
     std::vector<int> get_stagnant_species(int generation);
     std::map<int, int> calc_spawns(std::map<int, float> adj_fitnesses, std::map<int, int> prev_sizes);
     std::map<int, Genome_ptr> reproduce(int generation);
+    GenomeArena_ptr next_arena();
 };
 
 #endif // POPULATION_H
\ No newline at end of file
@@ -1,8 +1,49 @@
 #ifndef RANDOM_GENERATOR_H
 #define RANDOM_GENERATOR_H
 #include <random>
+#include <cstddef>
 
-int seed = 8675309;
-std::default_random_engine generator(seed);
+inline int seed = 8675309;
+inline std::default_random_engine generator(seed);
+
+/**
+ * @brief Runs a Bernoulli trial with probability rate for every index below count and
+ * calls hit with each index that succeeds, in increasing order.
+ * Instead of one draw per index the gap to the next success is drawn from a geometric
+ * distribution, so the work is proportional to the number of successes
+ *
+ * @tparam Hit callable size_t -> void
+ * @param count number of trials
+ * @param rate success probability of every trial
+ * @param hit
+ */
+template <typename Hit>
+void for_each_bernoulli(size_t count, float rate, Hit hit)
+{
+    if (rate <= 0.0F)
+    {
+        return;
+    }
+    if (rate >= 1.0F)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            hit(i);
+        }
+        return;
+    }
+    std::geometric_distribution<size_t> gap(rate);
+    for (size_t i = 0;; i++)
+    {
+        // failures before the next success
+        size_t skip = gap(generator);
+        if (skip >= count - i)
+        {
+            return;
+        }
+        i += skip;
+        hit(i);
+    }
+}
 
 #endif // RANDOM_GENERATOR_H
@@ -0,0 +1,361 @@
+#include "activation_kernels.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include "activations.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define NEAT_X86_KERNELS 1
+// GCC 12 warns about the _mm*_undefined_* placeholders inside its own intrinsics once they are inlined
+#if !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+#include <immintrin.h>
+#if !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#else
+#define NEAT_X86_KERNELS 0
+#endif
+
+/// ------------ Scalar Kernels ------------///
+
+namespace scalar_kernels
+{
+    static void activate(valid_activations method, valid_precisions precision, float *values, size_t n)
+    {
+        for (size_t i = 0; i < n; i++)
+        {
+            values[i] = activate_value(values[i], method, precision);
+        }
+    }
+} // namespace scalar_kernels
+
+#if NEAT_X86_KERNELS
+
+/// ------------ SSE Kernels ------------///
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("sse2")
+#endif
+
+namespace sse_kernels
+{
+    typedef __m128 vf;
+    typedef __m128i vi;
+    typedef __m128 vm;
+    constexpr size_t width = 4;
+
+    static inline vf v_load(const float *p) { return _mm_loadu_ps(p); }
+    static inline void v_store(float *p, vf a) { _mm_storeu_ps(p, a); }
+    static inline vf v_set(float a) { return _mm_set1_ps(a); }
+    static inline vf v_add(vf a, vf b) { return _mm_add_ps(a, b); }
+    static inline vf v_sub(vf a, vf b) { return _mm_sub_ps(a, b); }
+    static inline vf v_mul(vf a, vf b) { return _mm_mul_ps(a, b); }
+    static inline vf v_div(vf a, vf b) { return _mm_div_ps(a, b); }
+    static inline vf v_fmadd(vf a, vf b, vf c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    static inline vf v_max(vf a, vf b) { return _mm_max_ps(a, b); }
+    static inline vf v_min(vf a, vf b) { return _mm_min_ps(a, b); }
+    static inline vm v_lt(vf a, vf b) { return _mm_cmplt_ps(a, b); }
+    static inline vm v_le(vf a, vf b) { return _mm_cmple_ps(a, b); }
+    static inline bool v_any(vm m) { return _mm_movemask_ps(m) != 0; }
+    static inline vf v_select(vm m, vf a, vf b) { return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b)); }
+    static inline vi v_round(vf a) { return _mm_cvtps_epi32(a); }
+    static inline vi v_trunc(vf a) { return _mm_cvttps_epi32(a); }
+    // SSE has no gather, the lanes are loaded one by one
+    static inline void v_gather_pair(const float *base, vi index, vf *lower, vf *upper)
+    {
+        alignas(16) int i[width];
+        _mm_store_si128(reinterpret_cast<__m128i *>(i), index);
+        *lower = _mm_setr_ps(base[i[0]], base[i[1]], base[i[2]], base[i[3]]);
+        *upper = _mm_setr_ps(base[i[0] + 1], base[i[1] + 1], base[i[2] + 1], base[i[3] + 1]);
+    }
+    static inline vf v_to_float(vi a) { return _mm_cvtepi32_ps(a); }
+    static inline vf v_xor(vf a, vf b) { return _mm_xor_ps(a, b); }
+    static inline vf v_and_bits(vf a, unsigned bits) { return _mm_and_ps(a, _mm_castsi128_ps(_mm_set1_epi32(bits))); }
+    static inline vf v_odd_sign(vi n) { return _mm_castsi128_ps(_mm_slli_epi32(n, 31)); }
+    static inline vf v_pow2(vi n) { return _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23)); }
+    static inline vf v_ldexp(vf y, vi n)
+    {
+        // split the scale in two so 2^n never leaves the normal range on its own
+        const vi half = _mm_srai_epi32(n, 1);
+        return _mm_mul_ps(_mm_mul_ps(y, v_pow2(half)), v_pow2(_mm_sub_epi32(n, half)));
+    }
+    static inline vf v_frexp(vf x, vf *e)
+    {
+        const vi bits = _mm_castps_si128(x);
+        *e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_and_si128(_mm_srli_epi32(bits, 23), _mm_set1_epi32(0xff)), _mm_set1_epi32(126)));
+        return _mm_or_ps(v_and_bits(x, 0x807fffffU), _mm_castsi128_ps(_mm_set1_epi32(0x3f000000)));
+    }
+
+#include "activation_kernels.inl"
+} // namespace sse_kernels
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+/// ------------ AVX2 Kernels ------------///
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,fma"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#endif
+
+namespace avx2_kernels
+{
+    typedef __m256 vf;
+    typedef __m256i vi;
+    typedef __m256 vm;
+    constexpr size_t width = 8;
+
+    static inline vf v_load(const float *p) { return _mm256_loadu_ps(p); }
+    static inline void v_store(float *p, vf a) { _mm256_storeu_ps(p, a); }
+    static inline vf v_set(float a) { return _mm256_set1_ps(a); }
+    static inline vf v_add(vf a, vf b) { return _mm256_add_ps(a, b); }
+    static inline vf v_sub(vf a, vf b) { return _mm256_sub_ps(a, b); }
+    static inline vf v_mul(vf a, vf b) { return _mm256_mul_ps(a, b); }
+    static inline vf v_div(vf a, vf b) { return _mm256_div_ps(a, b); }
+    static inline vf v_fmadd(vf a, vf b, vf c) { return _mm256_fmadd_ps(a, b, c); }
+    static inline vf v_max(vf a, vf b) { return _mm256_max_ps(a, b); }
+    static inline vf v_min(vf a, vf b) { return _mm256_min_ps(a, b); }
+    static inline vm v_lt(vf a, vf b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static inline vm v_le(vf a, vf b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    static inline bool v_any(vm m) { return _mm256_movemask_ps(m) != 0; }
+    static inline vf v_select(vm m, vf a, vf b) { return _mm256_blendv_ps(b, a, m); }
+    static inline vi v_round(vf a) { return _mm256_cvtps_epi32(a); }
+    static inline vi v_trunc(vf a) { return _mm256_cvttps_epi32(a); }
+    static inline void v_gather_pair(const float *base, vi index, vf *lower, vf *upper)
+    {
+        // each 64 bit gather loads base[i] and base[i + 1] together, then the pairs are split
+        const double *pairs = reinterpret_cast<const double *>(base);
+        const vf a = _mm256_castpd_ps(_mm256_i32gather_pd(pairs, _mm256_castsi256_si128(index), 4));
+        const vf b = _mm256_castpd_ps(_mm256_i32gather_pd(pairs, _mm256_extracti128_si256(index, 1), 4));
+        *lower = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0))), _MM_SHUFFLE(3, 1, 2, 0)));
+        *upper = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1))), _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+    static inline vf v_to_float(vi a) { return _mm256_cvtepi32_ps(a); }
+    static inline vf v_xor(vf a, vf b) { return _mm256_xor_ps(a, b); }
+    static inline vf v_and_bits(vf a, unsigned bits) { return _mm256_and_ps(a, _mm256_castsi256_ps(_mm256_set1_epi32(bits))); }
+    static inline vf v_odd_sign(vi n) { return _mm256_castsi256_ps(_mm256_slli_epi32(n, 31)); }
+    static inline vf v_pow2(vi n) { return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n, _mm256_set1_epi32(127)), 23)); }
+    static inline vf v_ldexp(vf y, vi n)
+    {
+        // split the scale in two so 2^n never leaves the normal range on its own
+        const vi half = _mm256_srai_epi32(n, 1);
+        return _mm256_mul_ps(_mm256_mul_ps(y, v_pow2(half)), v_pow2(_mm256_sub_epi32(n, half)));
+    }
+    static inline vf v_frexp(vf x, vf *e)
+    {
+        const vi bits = _mm256_castps_si256(x);
+        *e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_and_si256(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(0xff)), _mm256_set1_epi32(126)));
+        return _mm256_or_ps(v_and_bits(x, 0x807fffffU), _mm256_castsi256_ps(_mm256_set1_epi32(0x3f000000)));
+    }
+
+#include "activation_kernels.inl"
+} // namespace avx2_kernels
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+/// ------------ AVX-512 Kernels ------------///
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+#endif
+
+namespace avx512_kernels
+{
+    typedef __m512 vf;
+    typedef __m512i vi;
+    typedef __mmask16 vm;
+    constexpr size_t width = 16;
+
+    static inline vf v_load(const float *p) { return _mm512_loadu_ps(p); }
+    static inline void v_store(float *p, vf a) { _mm512_storeu_ps(p, a); }
+    static inline vf v_set(float a) { return _mm512_set1_ps(a); }
+    static inline vf v_add(vf a, vf b) { return _mm512_add_ps(a, b); }
+    static inline vf v_sub(vf a, vf b) { return _mm512_sub_ps(a, b); }
+    static inline vf v_mul(vf a, vf b) { return _mm512_mul_ps(a, b); }
+    static inline vf v_div(vf a, vf b) { return _mm512_div_ps(a, b); }
+    static inline vf v_fmadd(vf a, vf b, vf c) { return _mm512_fmadd_ps(a, b, c); }
+    static inline vf v_max(vf a, vf b) { return _mm512_max_ps(a, b); }
+    static inline vf v_min(vf a, vf b) { return _mm512_min_ps(a, b); }
+    static inline vm v_lt(vf a, vf b) { return _mm512_cmp_ps_mask(a, b, _CMP_LT_OQ); }
+    static inline vm v_le(vf a, vf b) { return _mm512_cmp_ps_mask(a, b, _CMP_LE_OQ); }
+    static inline bool v_any(vm m) { return m != 0; }
+    static inline vf v_select(vm m, vf a, vf b) { return _mm512_mask_blend_ps(m, b, a); }
+    static inline vi v_round(vf a) { return _mm512_cvtps_epi32(a); }
+    static inline vi v_trunc(vf a) { return _mm512_cvttps_epi32(a); }
+    static inline void v_gather_pair(const float *base, vi index, vf *lower, vf *upper)
+    {
+        // each 64 bit gather loads base[i] and base[i + 1] together, then the pairs are split
+        const vf a = _mm512_castpd_ps(_mm512_i32gather_pd(_mm512_castsi512_si256(index), base, 4));
+        const vf b = _mm512_castpd_ps(_mm512_i32gather_pd(_mm512_extracti64x4_epi64(index, 1), base, 4));
+        const vi even = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+        *lower = _mm512_permutex2var_ps(a, even, b);
+        *upper = _mm512_permutex2var_ps(a, _mm512_add_epi32(even, _mm512_set1_epi32(1)), b);
+    }
+    static inline vf v_to_float(vi a) { return _mm512_cvtepi32_ps(a); }
+    // AVX-512F only has the bitwise operations on integer vectors
+    static inline vf v_xor(vf a, vf b) { return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a), _mm512_castps_si512(b))); }
+    static inline vf v_and_bits(vf a, unsigned bits) { return _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(a), _mm512_set1_epi32(bits))); }
+    static inline vf v_odd_sign(vi n) { return _mm512_castsi512_ps(_mm512_slli_epi32(n, 31)); }
+    static inline vf v_pow2(vi n) { return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_add_epi32(n, _mm512_set1_epi32(127)), 23)); }
+    static inline vf v_ldexp(vf y, vi n)
+    {
+        // split the scale in two so 2^n never leaves the normal range on its own
+        const vi half = _mm512_srai_epi32(n, 1);
+        return _mm512_mul_ps(_mm512_mul_ps(y, v_pow2(half)), v_pow2(_mm512_sub_epi32(n, half)));
+    }
+    static inline vf v_frexp(vf x, vf *e)
+    {
+        const vi bits = _mm512_castps_si512(x);
+        *e = _mm512_cvtepi32_ps(_mm512_sub_epi32(_mm512_and_si512(_mm512_srli_epi32(bits, 23), _mm512_set1_epi32(0xff)), _mm512_set1_epi32(126)));
+        return _mm512_castsi512_ps(_mm512_or_si512(_mm512_castps_si512(v_and_bits(x, 0x807fffffU)), _mm512_set1_epi32(0x3f000000)));
+    }
+
+#include "activation_kernels.inl"
+} // namespace avx512_kernels
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#endif // NEAT_X86_KERNELS
+
+/// ------------ Dispatch ------------///
+
+/**
+ * @brief finds the fastest instruction set the running CPU supports
+ *
+ * @return simd_level
+ */
+simd_level detect_simd_level()
+{
+#if NEAT_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f"))
+    {
+        return simd_level::avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    {
+        return simd_level::avx2;
+    }
+    if (__builtin_cpu_supports("sse2"))
+    {
+        return simd_level::sse;
+    }
+#endif
+    return simd_level::scalar;
+}
+/**
+ * @brief gets the instruction set activate_array uses, detected once on first use
+ *
+ * @return simd_level
+ */
+simd_level get_simd_level()
+{
+    static const simd_level level = detect_simd_level();
+    return level;
+}
+/**
+ * @brief checks whether kernels for level can run on this CPU
+ *
+ * @param level
+ * @return true
+ * @return false
+ */
+bool simd_level_supported(simd_level level)
+{
+    return level <= get_simd_level();
+}
+/**
+ * @brief applies the activation to every value in place with the fastest supported kernels
+ *
+ * @param method activation to apply
+ * @param values array of n values
+ * @param n
+ */
+void activate_array(valid_activations method, float *values, size_t n)
+{
+    activate_array(method, valid_precisions::exact, values, n, get_simd_level());
+}
+/**
+ * @brief applies the activation to every value in place with the kernels for level
+ *
+ * @param method activation to apply
+ * @param values array of n values
+ * @param n
+ * @param level instruction set to use, must be supported by this CPU
+ */
+void activate_array(valid_activations method, float *values, size_t n, simd_level level)
+{
+    activate_array(method, valid_precisions::exact, values, n, level);
+}
+/**
+ * @brief applies the activation at the given precision to every value in place with the
+ * fastest supported kernels
+ *
+ * @param method activation to apply
+ * @param precision how closely the transcendental activations are computed
+ * @param values array of n values
+ * @param n
+ */
+void activate_array(valid_activations method, valid_precisions precision, float *values, size_t n)
+{
+    activate_array(method, precision, values, n, get_simd_level());
+}
+/**
+ * @brief applies the activation at the given precision to every value in place with the
+ * kernels for level
+ *
+ * @param method activation to apply
+ * @param precision how closely the transcendental activations are computed
+ * @param values array of n values
+ * @param n
+ * @param level instruction set to use, must be supported by this CPU
+ */
+void activate_array(valid_activations method, valid_precisions precision, float *values, size_t n, simd_level level)
+{
+    if (!simd_level_supported(level))
+    {
+        throw std::invalid_argument("SIMD level " + std::to_string(static_cast<int>(level)) + " is not supported by this CPU");
+    }
+    switch (level)
+    {
+#if NEAT_X86_KERNELS
+    case (simd_level::avx512):
+        avx512_kernels::activate(method, precision, values, n);
+        return;
+    case (simd_level::avx2):
+        avx2_kernels::activate(method, precision, values, n);
+        return;
+    case (simd_level::sse):
+        sse_kernels::activate(method, precision, values, n);
+        return;
+#endif
+    default:
+        scalar_kernels::activate(method, precision, values, n);
+        return;
+    }
+}
@@ -0,0 +1,394 @@
+// Instruction set independent activation kernels.
+//
+// This file is included once per instruction set by activation_kernels.cpp, inside a
+// namespace that first defines the vector types (vf, vi, vm), the vector width and the
+// v_* primitives for that instruction set. Every function here therefore gets compiled
+// for the instruction set of the namespace it is included into.
+//
+// The transcendental functions follow the single precision Cephes approximations, each
+// is within a few ulp of the scalar std:: versions over the range a network produces.
+// v_min and v_max return their second operand when either is NaN, clamps therefore take
+// the value last so NaN propagates like it does through the scalar activations.
+
+/**
+ * @brief e^x, overflowing to inf and flushing to 0 where std::exp would produce a denormal
+ */
+static inline vf exp_v(vf x)
+{
+    const vf max_x = v_set(88.72283905206835F);
+    const vf min_x = v_set(-87.33654475055310898657F);
+    const vm overflow = v_lt(max_x, x);
+    const vm underflow = v_lt(x, min_x);
+    x = v_min(max_x, v_max(min_x, x));
+
+    // e^x = 2^n * e^r with |r| <= ln(2) / 2
+    const vi n = v_round(v_mul(x, v_set(1.44269504088896341F)));
+    const vf nf = v_to_float(n);
+    vf r = v_fmadd(nf, v_set(-0.693359375F), x);
+    r = v_fmadd(nf, v_set(2.12194440e-4F), r);
+
+    const vf z = v_mul(r, r);
+    vf y = v_set(1.9875691500E-4F);
+    y = v_fmadd(y, r, v_set(1.3981999507E-3F));
+    y = v_fmadd(y, r, v_set(8.3334519073E-3F));
+    y = v_fmadd(y, r, v_set(4.1665795894E-2F));
+    y = v_fmadd(y, r, v_set(1.6666665459E-1F));
+    y = v_fmadd(y, r, v_set(5.0000001201E-1F));
+    y = v_add(v_fmadd(y, z, r), v_set(1.0F));
+
+    y = v_ldexp(y, n);
+    y = v_select(overflow, v_set(std::numeric_limits<float>::infinity()), y);
+    return v_select(underflow, v_set(0.0F), y);
+}
+
+/**
+ * @brief natural logarithm for positive, finite x
+ */
+static inline vf log_v(vf x)
+{
+    // x = m * 2^e with m in [0.5, 1)
+    vf e;
+    vf m = v_frexp(x, &e);
+
+    // shift m into [sqrt(0.5), sqrt(2)) so the polynomial stays accurate
+    const vm small = v_lt(m, v_set(0.707106781186547524F));
+    e = v_select(small, v_sub(e, v_set(1.0F)), e);
+    m = v_select(small, v_sub(v_add(m, m), v_set(1.0F)), v_sub(m, v_set(1.0F)));
+
+    const vf z = v_mul(m, m);
+    vf y = v_set(7.0376836292E-2F);
+    y = v_fmadd(y, m, v_set(-1.1514610310E-1F));
+    y = v_fmadd(y, m, v_set(1.1676998740E-1F));
+    y = v_fmadd(y, m, v_set(-1.2420140846E-1F));
+    y = v_fmadd(y, m, v_set(1.4249322787E-1F));
+    y = v_fmadd(y, m, v_set(-1.6668057665E-1F));
+    y = v_fmadd(y, m, v_set(2.0000714765E-1F));
+    y = v_fmadd(y, m, v_set(-2.4999993993E-1F));
+    y = v_fmadd(y, m, v_set(3.3333331174E-1F));
+    y = v_mul(v_mul(y, m), z);
+
+    y = v_fmadd(e, v_set(-2.12194440e-4F), y);
+    y = v_fmadd(z, v_set(-0.5F), y);
+    return v_fmadd(e, v_set(0.693359375F), v_add(m, y));
+}
+
+// largest |x| the three part reduction in sin_v keeps n * pi exact for
+constexpr float sin_max_x = 8192.0F;
+
+/**
+ * @brief sine, accurate to ~1e-7 absolute, lanes beyond sin_max_x fall back to std::sin
+ */
+static inline vf sin_v(vf x)
+{
+    // x = n * pi + r with |r| <= pi / 2, pi split in three so n * pi is exact
+    const vi n = v_round(v_mul(x, v_set(0.318309886183790671538F)));
+    const vf nf = v_to_float(n);
+    vf r = v_fmadd(nf, v_set(-3.140625F), x);
+    r = v_fmadd(nf, v_set(-9.67502593994140625E-4F), r);
+    r = v_fmadd(nf, v_set(-1.509957990978376432E-7F), r);
+
+    const vf z = v_mul(r, r);
+    vf y = v_set(-2.5052108385441718775E-8F);
+    y = v_fmadd(y, z, v_set(2.7557319223985890653E-6F));
+    y = v_fmadd(y, z, v_set(-1.9841269841269841270E-4F));
+    y = v_fmadd(y, z, v_set(8.3333333333333333333E-3F));
+    y = v_fmadd(y, z, v_set(-1.6666666666666666667E-1F));
+    y = v_fmadd(v_mul(y, z), r, r);
+
+    // sin(n * pi + r) = (-1)^n * sin(r)
+    y = v_xor(y, v_odd_sign(n));
+
+    // large inputs are rare, so the scalar fallback only runs when a lane needs it
+    if (v_any(v_lt(v_set(sin_max_x), v_and_bits(x, 0x7fffffffU))))
+    {
+        float xs[width];
+        float ys[width];
+        v_store(xs, x);
+        v_store(ys, y);
+        for (size_t i = 0; i < width; i++)
+        {
+            if (std::fabs(xs[i]) > sin_max_x)
+            {
+                ys[i] = std::sin(xs[i]);
+            }
+        }
+        y = v_load(ys);
+    }
+    return y;
+}
+
+static inline vf sigmoid_v(vf x)
+{
+    return v_div(v_set(1.0F), v_add(v_set(1.0F), exp_v(v_sub(v_set(0.0F), x))));
+}
+
+static inline vf tanh_v(vf x)
+{
+    const vf ax = v_and_bits(x, 0x7fffffffU);
+
+    // |x| < 0.625: odd polynomial, avoids the cancellation in 1 - 2 / (e^2x + 1)
+    const vf z = v_mul(x, x);
+    vf y_small = v_set(-5.70498872745E-3F);
+    y_small = v_fmadd(y_small, z, v_set(2.06390887954E-2F));
+    y_small = v_fmadd(y_small, z, v_set(-5.37397155531E-2F));
+    y_small = v_fmadd(y_small, z, v_set(1.33314422036E-1F));
+    y_small = v_fmadd(y_small, z, v_set(-3.33332819422E-1F));
+    y_small = v_fmadd(v_mul(y_small, z), x, x);
+
+    // tanh saturates to 1 in single precision well before |x| = 9
+    const vf e = exp_v(v_add(v_min(v_set(9.0F), ax), v_min(v_set(9.0F), ax)));
+    vf y_large = v_sub(v_set(1.0F), v_div(v_set(2.0F), v_add(e, v_set(1.0F))));
+    y_large = v_xor(y_large, v_and_bits(x, 0x80000000U));
+
+    return v_select(v_lt(ax, v_set(0.625F)), y_small, y_large);
+}
+
+static inline vf gauss_v(vf x)
+{
+    return exp_v(v_mul(x, x));
+}
+
+static inline vf softplus_v(vf x)
+{
+    // log1p(e^x) as log(u) * (e^x / (u - 1)) with u = 1 + e^x, keeps full precision for small e^x
+    const vf e = exp_v(x);
+    const vf u = v_add(v_set(1.0F), e);
+    const vf d = v_sub(u, v_set(1.0F));
+    vf y = v_mul(log_v(u), v_div(e, d));
+    y = v_select(v_lt(d, v_set(std::numeric_limits<float>::min())), e, y);
+    // log1p(e^x) == x once e^-x is below float resolution
+    return v_select(v_lt(v_set(15.0F), x), x, y);
+}
+
+static inline vf relu_v(vf x)
+{
+    return v_max(x, v_set(0.0F));
+}
+
+static inline vf clamped_v(vf x)
+{
+    return v_min(v_set(1.0F), v_max(v_set(-1.0F), x));
+}
+
+static inline vf abs_v(vf x)
+{
+    return v_and_bits(x, 0x7fffffffU);
+}
+
+static inline vf square_v(vf x)
+{
+    return v_mul(x, x);
+}
+
+static inline vf cubed_v(vf x)
+{
+    return v_mul(v_mul(x, x), x);
+}
+
+/// ------------ Fast Precision ------------///
+
+/**
+ * @brief floor for |x| < 2^31
+ */
+static inline vf floor_v(vf x)
+{
+    const vf r = v_to_float(v_round(x));
+    return v_select(v_lt(x, r), v_sub(r, v_set(1.0F)), r);
+}
+
+/**
+ * @brief vector version of fast_exp
+ */
+static inline vf fast_exp_v(vf x)
+{
+    const vf max_x = v_set(88.7228390F);
+    const vf min_x = v_set(-87.3365447F);
+    const vm overflow = v_lt(max_x, x);
+    const vm underflow = v_lt(x, min_x);
+    x = v_min(max_x, v_max(min_x, x));
+
+    // e^x = 2^n * 2^f with f in [0, 1), 2^f from a degree 4 polynomial
+    const vf t = v_mul(x, v_set(1.44269504F));
+    const vf n = floor_v(t);
+    const vf f = v_sub(t, n);
+    vf p = v_set(1.367030945e-02F);
+    p = v_fmadd(p, f, v_set(5.174499776e-02F));
+    p = v_fmadd(p, f, v_set(2.416043573e-01F));
+    p = v_fmadd(p, f, v_set(6.929729222e-01F));
+    p = v_fmadd(p, f, v_set(1.000003493e+00F));
+
+    const vf y = v_ldexp(p, v_round(n));
+    return v_select(underflow, v_set(0.0F), v_select(overflow, v_set(std::numeric_limits<float>::infinity()), y));
+}
+
+/**
+ * @brief vector version of fast_log1p_unit
+ */
+static inline vf fast_log1p_unit_v(vf t)
+{
+    vf p = v_set(-3.382204597e-02F);
+    p = v_fmadd(p, t, v_set(1.444710957e-01F));
+    p = v_fmadd(p, t, v_set(-3.016380097e-01F));
+    p = v_fmadd(p, t, v_set(4.686588791e-01F));
+    p = v_fmadd(p, t, v_set(-7.203587727e-01F));
+    p = v_fmadd(p, t, v_set(1.442681468e+00F));
+    return v_mul(v_mul(v_set(0.693147181F), t), p);
+}
+
+static inline vf fast_sigmoid_v(vf x)
+{
+    return v_div(v_set(1.0F), v_add(v_set(1.0F), fast_exp_v(v_sub(v_set(0.0F), x))));
+}
+
+static inline vf fast_tanh_v(vf x)
+{
+    return v_sub(v_set(1.0F), v_div(v_set(2.0F), v_add(fast_exp_v(v_add(x, x)), v_set(1.0F))));
+}
+
+static inline vf fast_gauss_v(vf x)
+{
+    return fast_exp_v(v_mul(x, x));
+}
+
+static inline vf fast_softplus_v(vf x)
+{
+    const vf e = fast_exp_v(v_sub(v_set(0.0F), v_and_bits(x, 0x7fffffffU)));
+    return v_add(v_max(v_set(0.0F), x), fast_log1p_unit_v(e));
+}
+
+/// ------------ Lookup Table Precision ------------///
+
+/**
+ * @brief vector version of InterpolationTable::lookup, lanes outside the table read its ends
+ */
+static inline vf lookup_v(const InterpolationTable &table, vf x)
+{
+    const vf pos = v_mul(v_sub(x, v_set(table.low)), v_set(table.inv_step));
+    // clamping before the conversion keeps every index, even of NaN lanes, inside the table
+    const vf last = v_set(static_cast<float>(table.samples.size() - 2));
+    const vi i = v_trunc(v_min(v_max(pos, v_set(0.0F)), last));
+    vf lower;
+    vf upper;
+    v_gather_pair(table.samples.data(), i, &lower, &upper);
+    return v_fmadd(v_sub(pos, v_to_float(i)), v_sub(upper, lower), lower);
+}
+
+static inline vf lut_sigmoid_v(vf x)
+{
+    static const InterpolationTable &table = lut_table(sigmoid_act);
+    const vf y = v_select(v_le(v_set(16.0F), x), v_set(1.0F), lookup_v(table, x));
+    return v_select(v_le(x, v_set(-16.0F)), v_set(0.0F), y);
+}
+
+static inline vf lut_tanh_v(vf x)
+{
+    static const InterpolationTable &table = lut_table(tanh_act);
+    const vf y = v_select(v_le(v_set(8.0F), x), v_set(1.0F), lookup_v(table, x));
+    return v_select(v_le(x, v_set(-8.0F)), v_set(-1.0F), y);
+}
+
+static inline vf lut_gauss_v(vf x)
+{
+    // e^(x^2) = 2^n * 2^f, only 2^f for f in [0, 1) is tabulated
+    static const InterpolationTable &table = lut_table(gauss_act);
+    const vf t = v_mul(v_mul(x, x), v_set(1.44269504F));
+    const vf n = v_to_float(v_trunc(v_min(v_set(127.0F), t)));
+    const vf y = v_mul(lookup_v(table, v_sub(t, n)), v_pow2(v_round(n)));
+    return v_select(v_le(v_set(128.0F), t), v_set(std::numeric_limits<float>::infinity()), y);
+}
+
+static inline vf lut_softplus_v(vf x)
+{
+    static const InterpolationTable &table = lut_table(softplus_act);
+    const vf y = v_select(v_le(v_set(16.0F), x), x, lookup_v(table, x));
+    return v_select(v_le(x, v_set(-16.0F)), v_set(0.0F), y);
+}
+
+// Applies kernel to every value, the tail that doesn't fill a vector is padded so every
+// element goes through the same code path
+#define ACTIVATION_KERNEL_LOOP(kernel)                      \
+    {                                                       \
+        size_t i = 0;                                       \
+        for (; i + width <= n; i += width)                  \
+        {                                                   \
+            v_store(values + i, kernel(v_load(values + i))); \
+        }                                                   \
+        if (i < n)                                          \
+        {                                                   \
+            float tail[width] = {};                         \
+            std::copy(values + i, values + n, tail);        \
+            v_store(tail, kernel(v_load(tail)));            \
+            std::copy(tail, tail + (n - i), values + i);    \
+        }                                                   \
+        break;                                              \
+    }
+
+static void activate(valid_activations method, float *values, size_t n)
+{
+    switch (method)
+    {
+    case (linear_act):
+        break;
+    case (sigmoid_act):
+        ACTIVATION_KERNEL_LOOP(sigmoid_v)
+    case (tanh_act):
+        ACTIVATION_KERNEL_LOOP(tanh_v)
+    case (sin_act):
+        ACTIVATION_KERNEL_LOOP(sin_v)
+    case (gauss_act):
+        ACTIVATION_KERNEL_LOOP(gauss_v)
+    case (relu_act):
+        ACTIVATION_KERNEL_LOOP(relu_v)
+    case (softplus_act):
+        ACTIVATION_KERNEL_LOOP(softplus_v)
+    case (clamped_act):
+        ACTIVATION_KERNEL_LOOP(clamped_v)
+    case (abs_act):
+        ACTIVATION_KERNEL_LOOP(abs_v)
+    case (square_act):
+        ACTIVATION_KERNEL_LOOP(square_v)
+    case (cubed_act):
+        ACTIVATION_KERNEL_LOOP(cubed_v)
+    };
+}
+
+static void activate(valid_activations method, valid_precisions precision, float *values, size_t n)
+{
+    if (precision == valid_precisions::fast)
+    {
+        switch (method)
+        {
+        case (sigmoid_act):
+            ACTIVATION_KERNEL_LOOP(fast_sigmoid_v)
+        case (tanh_act):
+            ACTIVATION_KERNEL_LOOP(fast_tanh_v)
+        case (gauss_act):
+            ACTIVATION_KERNEL_LOOP(fast_gauss_v)
+        case (softplus_act):
+            ACTIVATION_KERNEL_LOOP(fast_softplus_v)
+        default:
+            activate(method, values, n);
+        };
+        return;
+    }
+    if (precision == valid_precisions::lut)
+    {
+        switch (method)
+        {
+        case (sigmoid_act):
+            ACTIVATION_KERNEL_LOOP(lut_sigmoid_v)
+        case (tanh_act):
+            ACTIVATION_KERNEL_LOOP(lut_tanh_v)
+        case (gauss_act):
+            ACTIVATION_KERNEL_LOOP(lut_gauss_v)
+        case (softplus_act):
+            ACTIVATION_KERNEL_LOOP(lut_softplus_v)
+        default:
+            activate(method, values, n);
+        };
+        return;
+    }
+    activate(method, values, n);
+}
+
+#undef ACTIVATION_KERNEL_LOOP
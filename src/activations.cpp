@@ -1,13 +1,151 @@
 #include "activations.h"
 #include <stdexcept>
+#include <vector>
 
-float activate_value(float x, std::string method)
+InterpolationTable::InterpolationTable(double (*f)(double), float _low, float high, int num_steps)
 {
-    if (act_map.count(method) == 0)
+    low = _low;
+    inv_step = static_cast<float>(num_steps) / (high - _low);
+    samples.resize(num_steps + 1);
+    for (int i = 0; i <= num_steps; i++)
+    {
+        samples[i] = static_cast<float>(f(_low + (high - _low) * static_cast<double>(i) / num_steps));
+    }
+}
+
+// Tables are built on first use, outside their range each function has saturated
+// to within 2e-7 of its asymptote
+static double sigmoid_exact(double x) { return 1.0 / (1.0 + std::exp(-x)); }
+static double tanh_exact(double x) { return std::tanh(x); }
+static double softplus_exact(double x) { return std::log1p(std::exp(x)); }
+static double exp2_exact(double x) { return std::exp2(x); }
+
+/**
+ * @brief table the lut precision interpolates for method, for gauss it holds 2^f on [0, 1]
+ *
+ * @param method sigmoid, tanh, gauss or softplus
+ * @return const InterpolationTable&
+ */
+const InterpolationTable &lut_table(valid_activations method)
+{
+    switch (method)
+    {
+    case (sigmoid_act):
+    {
+        static const InterpolationTable table(sigmoid_exact, -16.0F, 16.0F, 2048);
+        return table;
+    }
+    case (tanh_act):
+    {
+        static const InterpolationTable table(tanh_exact, -8.0F, 8.0F, 2048);
+        return table;
+    }
+    case (gauss_act):
+    {
+        static const InterpolationTable table(exp2_exact, 0.0F, 1.0F, 256);
+        return table;
+    }
+    case (softplus_act):
+    {
+        static const InterpolationTable table(softplus_exact, -16.0F, 16.0F, 2048);
+        return table;
+    }
+    default:
+        throw std::invalid_argument("No lookup table for activation '" + activation_name(method) + "'");
+    }
+}
+
+float lut_sigmoid_activation(float x)
+{
+    static const InterpolationTable &table = lut_table(sigmoid_act);
+    if (x <= -16.0F || x >= 16.0F)
+    {
+        return (x > 0.0F) ? 1.0F : 0.0F;
+    }
+    return table.lookup(x);
+}
+
+float lut_tanh_activation(float x)
+{
+    static const InterpolationTable &table = lut_table(tanh_act);
+    if (x <= -8.0F || x >= 8.0F)
+    {
+        return (x > 0.0F) ? 1.0F : -1.0F;
+    }
+    return table.lookup(x);
+}
+
+float lut_gauss_activation(float x)
+{
+    // e^(x^2) = 2^n * 2^f, only 2^f for f in [0, 1) is tabulated
+    static const InterpolationTable &table = lut_table(gauss_act);
+    const float t = x * x * 1.44269504F;
+    if (std::isnan(t))
+    {
+        return t;
+    }
+    if (t >= 128.0F)
+    {
+        return std::numeric_limits<float>::infinity();
+    }
+    const float n = std::floor(t);
+    return table.lookup(t - n) * pow2_int(static_cast<int>(n));
+}
+
+float lut_softplus_activation(float x)
+{
+    static const InterpolationTable &table = lut_table(softplus_act);
+    if (x <= -16.0F)
+    {
+        return 0.0F;
+    }
+    if (x >= 16.0F)
+    {
+        return x;
+    }
+    return table.lookup(x);
+}
+
+valid_activations to_activation(const std::string &method)
+{
+    std::map<std::string, valid_activations>::const_iterator it = act_map.find(method);
+    if (it == act_map.end())
     {
         throw std::invalid_argument("Invalid Activation '" + method + "' provided");
     }
-    switch (act_map[method])
+    return it->second;
+}
+
+std::string activation_name(valid_activations method)
+{
+    for (const std::pair<const std::string, valid_activations> &act : act_map)
+    {
+        if (act.second == method)
+        {
+            return act.first;
+        }
+    }
+    throw std::invalid_argument("Invalid Activation '" + std::to_string(method) + "' provided");
+}
+
+valid_precisions to_precision(const std::string &precision)
+{
+    std::map<std::string, valid_precisions>::const_iterator it = precision_map.find(precision);
+    if (it == precision_map.end())
+    {
+        throw std::invalid_argument("Invalid Activation Precision '" + precision + "' provided");
+    }
+    return it->second;
+}
+
+float activate_value(float x, const std::string &method)
+{
+    return activate_value(x, to_activation(method));
+}
+
+float activate_value(float x, valid_activations method)
+{
+    switch (method)
     {
     case (linear_act):
         return linear_activation(x);
@@ -33,4 +171,49 @@ float activate_value(float x, std::string method)
         return cubed_activation(x);
     };
     return 0.0F;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief activates x, approximating the transcendental activations unless precision is exact
+ *
+ * @param x
+ * @param method
+ * @param precision
+ * @return float
+ */
+float activate_value(float x, valid_activations method, valid_precisions precision)
+{
+    if (precision == valid_precisions::fast)
+    {
+        switch (method)
+        {
+        case (sigmoid_act):
+            return fast_sigmoid_activation(x);
+        case (tanh_act):
+            return fast_tanh_activation(x);
+        case (gauss_act):
+            return fast_gauss_activation(x);
+        case (softplus_act):
+            return fast_softplus_activation(x);
+        default:
+            break;
+        };
+    }
+    else if (precision == valid_precisions::lut)
+    {
+        switch (method)
+        {
+        case (sigmoid_act):
+            return lut_sigmoid_activation(x);
+        case (tanh_act):
+            return lut_tanh_activation(x);
+        case (gauss_act):
+            return lut_gauss_activation(x);
+        case (softplus_act):
+            return lut_softplus_activation(x);
+        default:
+            break;
+        };
+    }
+    return activate_value(x, method);
+}
@@ -1,24 +1,50 @@
 #include "aggregations.h"
 #include <stdexcept>
 
-float aggregate_vector(std::vector<float> values, std::string method)
+valid_aggregations to_aggregation(const std::string &method)
 {
-    if (agg_map.count(method) == 0)
+    std::map<std::string, valid_aggregations>::const_iterator it = agg_map.find(method);
+    if (it == agg_map.end())
     {
         throw std::invalid_argument("Invalid Aggregation '" + method + "' Provided");
     }
-    switch (agg_map[method])
+    return it->second;
+}
+
+std::string aggregation_name(valid_aggregations method)
+{
+    for (const std::pair<const std::string, valid_aggregations> &agg : agg_map)
+    {
+        if (agg.second == method)
+        {
+            return agg.first;
+        }
+    }
+    throw std::invalid_argument("Invalid Aggregation '" + std::to_string(static_cast<int>(method)) + "' Provided");
+}
+
+float aggregate_vector(const std::vector<float> &values, const std::string &method)
+{
+    return aggregate_vector(values, to_aggregation(method));
+}
+
+float aggregate_vector(const std::vector<float> &values, valid_aggregations method)
+{
+    if (!is_streamable(method))
+    {
+        if (values.empty())
+        {
+            return 0.0F;
+        }
+        // the median reorders its values so it works on a copy
+        std::vector<float> sorted_values(values);
+        return median_aggregate(sorted_values);
+    }
+
+    float acc = aggregate_identity(method);
+    for (float value : values)
     {
-    case (valid_aggregations::sum):
-        return sum_aggregate(values);
-    case (valid_aggregations::mean):
-        return mean_aggregate(values);
-    case (valid_aggregations::max):
-        return max_aggregate(values);
-    case (valid_aggregations::min):
-        return min_aggregate(values);
-    case (valid_aggregations::median):
-        return median_aggregate(values);
-    };
-    return 0.0F;
-}
\ No newline at end of file
+        acc = aggregate_fold(method, acc, value);
+    }
+    return aggregate_finish(method, acc, values.size());
+}
@@ -3,24 +3,409 @@
 #include <string>
 #include <random>
 #include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <array>
+#include <limits>
+#include <numbers>
+#include <map>
+#include <mutex>
 
-/// ------------ BoolAttribute Definitions ------------///
+/// ------------ OptionSet Definitions ------------///
+
+/**
+ * @brief Get the shared OptionSet holding _options, creating it on first use
+ *
+ * @param _options
+ * @return OptionSet_ptr the same instance for every equal set of options
+ */
+OptionSet_ptr OptionSet::intern(const std::set<std::string> &_options)
+{
+    static std::map<std::set<std::string>, OptionSet_ptr> registry;
+    static std::mutex registry_mutex;
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    OptionSet_ptr &interned = registry[_options];
+    if (!interned)
+    {
+        interned = std::make_shared<OptionSet>(_options);
+    }
+    return interned;
+}
+
+/**
+ * @brief Construct a new Option Set:: Option Set object, use intern() to share instances
+ *
+ * @param _options
+ */
+OptionSet::OptionSet(const std::set<std::string> &_options)
+{
+    options.assign(_options.begin(), _options.end());
+}
+
+/**
+ * @brief number of options
+ *
+ * @return int
+ */
+int OptionSet::size() const { return static_cast<int>(options.size()); }
+
+/**
+ * @brief Gets the option with index id
+ *
+ * @param id
+ * @return const std::string&
+ */
+const std::string &OptionSet::at(int id) const { return options.at(id); }
+
+/**
+ * @brief Gets the index of option
+ *
+ * @param option
+ * @return int index of the option or -1 if it isn't an option
+ */
+int OptionSet::id(const std::string &option) const
+{
+    std::vector<std::string>::const_iterator it = std::lower_bound(options.begin(), options.end(), option);
+    return (it != options.end() && *it == option) ? static_cast<int>(it - options.begin()) : -1;
+}
+
+/// ------------ AttributeSpec Definitions ------------///
 
 // Constructors
 /**
- * @brief Construct a new Bool Attribute:: Bool Attribute object
+ * @brief Construct a new Attribute Spec:: Attribute Spec object for float or int attributes
  *
- * @param _name name of the Attribute
+ * @param _type float_attribute or int_attribute
+ * @param _name Name of the Attribute
+ * @param _mean Mean Value of the Attribue
+ * @param _stdev Standard Deviation of Values
+ * @param _init_type gauss/gaussian/normal or uniform
  * @param _mutate_rate probability of mutating the value
+ * @param _mutate_power Gaussian Standard deviation of mutations
+ * @param _min_value Minimum value of the attribute
+ * @param _max_value Maximum Value of the attribute
  */
-BoolAttribute::BoolAttribute(const std::string &_name,
-                             const float &_mutate_rate)
+AttributeSpec::AttributeSpec(AttributeTypes _type,
+                             const std::string &_name,
+                             float _mean,
+                             float _stdev,
+                             const std::string &_init_type,
+                             float _mutate_rate,
+                             float _mutate_power,
+                             float _min_value,
+                             float _max_value)
 {
+    type = _type;
     name = _name;
+    mean = _mean;
+    stdev = _stdev;
+    init_type = _init_type;
     mutate_rate = _mutate_rate;
+    mutate_power = _mutate_power;
+    min_value = _min_value;
+    max_value = _max_value;
+    options = nullptr;
 
     validate();
+}
+/**
+ * @brief Construct a new Attribute Spec:: Attribute Spec object for bool attributes
+ *
+ * @param _name Name of the Attribute
+ * @param _mutate_rate probability of mutating the value
+ */
+AttributeSpec::AttributeSpec(const std::string &_name,
+                             float _mutate_rate)
+    : AttributeSpec(bool_attribute, _name, 0.F, 0.F, "uniform", _mutate_rate, 0.F, 0.F, 1.F)
+{
+}
+/**
+ * @brief Construct a new Attribute Spec:: Attribute Spec object for string attributes
+ *
+ * @param _name Name of the Attribute
+ * @param _mutate_rate probability of mutating the value
+ * @param _options interned options, see OptionSet::intern
+ */
+AttributeSpec::AttributeSpec(const std::string &_name,
+                             float _mutate_rate,
+                             OptionSet_ptr _options)
+{
+    type = string_attribute;
+    name = _name;
+    mean = 0.F;
+    stdev = 0.F;
+    init_type = "uniform";
+    mutate_rate = _mutate_rate;
+    mutate_power = 0.F;
+    min_value = 0.F;
+    max_value = 0.F;
+    options = _options;
+
+    validate();
+}
+
+// Values
+/**
+ * @brief Draws an initial value from the distribution, clamped to [min_value, max_value]
+ *
+ * @return float
+ */
+float AttributeSpec::init_float() const
+{
+    float value;
+    if (init_type == "uniform")
+    {
+        std::uniform_real_distribution<float> init_dist(min_value, max_value);
+        value = init_dist(generator);
+    }
+    else
+    {
+        std::normal_distribution<float> init_dist(mean, stdev);
+        value = init_dist(generator);
+    }
+    return std::clamp(value, min_value, max_value);
+}
+/**
+ * @brief With probability mutate_rate perturbs value by a gaussian with stdev mutate_power
+ *
+ * @param value
+ * @return float
+ */
+float AttributeSpec::mutate_float(float value) const
+{
+    if (rand_bool(mutate_rate))
+    {
+        std::normal_distribution<float> distribution(0, mutate_power);
+        value = std::clamp(value + distribution(generator), min_value, max_value);
+    }
+    return value;
+}
+/**
+ * @brief Mutates every value like mutate_float, a batch at a time
+ * All random numbers of a batch are drawn first, the gaussians then come from a
+ * Box-Muller pass and the masked, clamped update is a plain loop over the values,
+ * so neither depends on a call per value. Low rates only visit the values that mutate
+ * (see for_each_bernoulli), a rate of 0 does nothing
+ *
+ * @param values contiguous values to mutate in place
+ */
+void AttributeSpec::mutate_floats(std::span<float> values) const
+{
+    if (mutate_rate <= 0.0F)
+    {
+        return;
+    }
+    if (mutate_rate < sparse_mutate_rate)
+    {
+        // few values mutate, jump straight to them instead of drawing for every value
+        std::normal_distribution<float> distribution(0, mutate_power);
+        for_each_bernoulli(values.size(), mutate_rate, [&](size_t i)
+                           { values[i] = std::clamp(values[i] + distribution(generator), min_value, max_value); });
+        return;
+    }
+    std::uniform_real_distribution<float> uniform(0.0F, 1.0F);
+    std::array<float, mutate_batch> fire;
+    std::array<float, mutate_batch> noise;
+    std::array<float, mutate_batch / 2> radius;
+    std::array<float, mutate_batch / 2> angle;
+    for (size_t start = 0; start < values.size(); start += mutate_batch)
+    {
+        const size_t count = std::min(mutate_batch, values.size() - start);
+        const size_t pairs = (count + 1) / 2;
+        for (size_t i = 0; i < count; i++)
+        {
+            fire[i] = uniform(generator);
+        }
+        for (size_t i = 0; i < pairs; i++)
+        {
+            // log(0) is undefined, keep the radius uniform in (0, 1]
+            radius[i] = std::max(1.0F - uniform(generator), std::numeric_limits<float>::min());
+            angle[i] = uniform(generator);
+        }
+
+        // every pair of uniforms gives two independent gaussians with stdev mutate_power
+        for (size_t i = 0; i < pairs; i++)
+        {
+            float r = mutate_power * std::sqrt(-2.0F * std::log(radius[i]));
+            float theta = 2.0F * std::numbers::pi_v<float> * angle[i];
+            noise[2 * i] = r * std::cos(theta);
+            noise[2 * i + 1] = r * std::sin(theta);
+        }
+
+        float *batch = values.data() + start;
+        for (size_t i = 0; i < count; i++)
+        {
+            batch[i] = fire[i] < mutate_rate ? std::clamp(batch[i] + noise[i], min_value, max_value) : batch[i];
+        }
+    }
+}
+/**
+ * @brief Draws an initial integer value, see init_float
+ *
+ * @return int
+ */
+int AttributeSpec::init_int() const
+{
+    int value;
+    if (init_type == "uniform")
+    {
+        std::uniform_int_distribution<int> init_dist(static_cast<int>(min_value), static_cast<int>(max_value));
+        value = init_dist(generator);
+    }
+    else
+    {
+        std::normal_distribution<float> init_dist(mean, stdev);
+        value = static_cast<int>(init_dist(generator));
+    }
+    return std::clamp(value, static_cast<int>(min_value), static_cast<int>(max_value));
+}
+/**
+ * @brief Mutates an integer value by a rounded gaussian, see mutate_float
+ *
+ * @param value
+ * @return int
+ */
+int AttributeSpec::mutate_int(int value) const
+{
+    if (rand_bool(mutate_rate))
+    {
+        std::normal_distribution<float> distribution(0, mutate_power);
+        value += static_cast<int>(std::round(distribution(generator)));
+        value = std::clamp(value, static_cast<int>(min_value), static_cast<int>(max_value));
+    }
+    return value;
+}
+/**
+ * @brief With probability mutate_rate replaces value by a fair coin flip
+ *
+ * @param value
+ * @return bool
+ */
+bool AttributeSpec::mutate_bool(bool value) const
+{
+    if (rand_bool(mutate_rate))
+    {
+        value = rand_bool(0.5);
+    }
+    return value;
+}
+/**
+ * @brief Picks the index of a random option
+ *
+ * @return int
+ */
+int AttributeSpec::init_option() const
+{
+    std::uniform_int_distribution<int> distribution(0, options->size() - 1);
+    return distribution(generator);
+}
+/**
+ * @brief With probability mutate_rate replaces value_id by the index of a random option
+ *
+ * @param value_id
+ * @return int
+ */
+int AttributeSpec::mutate_option(int value_id) const
+{
+    if (rand_bool(mutate_rate))
+    {
+        value_id = init_option();
+    }
+    return value_id;
+}
+
+/**
+ * @brief Provides a string detailing the spec for debugging
+ *
+ * @return std::string
+ */
+std::string AttributeSpec::to_string() const
+{
+    std::string ret_str = "(mr: " + std::to_string(mutate_rate);
+    if (type == float_attribute || type == int_attribute)
+    {
+        ret_str += ", mp: " + std::to_string(mutate_power) +
+                   ", min: " + std::to_string(min_value) +
+                   ", max: " + std::to_string(max_value);
+    }
+    else if (type == string_attribute)
+    {
+        ret_str += ", options: [";
+        for (const std::string &op : options->options)
+        {
+            ret_str += (op + ", ");
+        }
+        ret_str += "]";
+    }
+    return ret_str + ")";
+}
+/**
+ * @brief Validates the parameters used by the spec's type
+ *
+ * @return true
+ * @return false
+ */
+bool AttributeSpec::validate() const
+{
+    if (mutate_rate < 0)
+    {
+        throw(std::invalid_argument(name + " Mutate Rate (" + std::to_string(mutate_rate) + ") must be greater than 0"));
+    }
+    else if (mutate_rate > 1.0F)
+    {
+        throw(std::invalid_argument(name + " Mutate Rate (" + std::to_string(mutate_rate) + ") must be less than 1"));
+    }
+
+    if (type == string_attribute && (!options || options->size() <= 0))
+    {
+        throw(std::invalid_argument("You must provide at least 1 option to a StringAttribute"));
+    }
+    if (type != float_attribute && type != int_attribute)
+    {
+        return true;
+    }
+
+    if (min_value > max_value)
+    {
+        throw(std::invalid_argument(name + " Min Value: " + std::to_string(min_value) + " must be less than Max Value: " + std::to_string(max_value)));
+    }
+    if (mean > max_value)
+    {
+        throw(std::invalid_argument(name + " Mean Value: " + std::to_string(mean) + " must be less than Max Value: " + std::to_string(max_value)));
+    }
+    if (mean < min_value)
+    {
+        throw(std::invalid_argument(name + " Mean Value: " + std::to_string(mean) + " must be greater than Min Value: " + std::to_string(min_value)));
+    }
+    if (stdev < 0)
+    {
+        throw(std::invalid_argument(name + " Standard Deviation (" + std::to_string(stdev) + ") must be greater than 0"));
+    }
+    if (mutate_power < 0)
+    {
+        throw(std::invalid_argument(name + " Mutate Power (" + std::to_string(mutate_power) + ") must be greater than 0"));
+    }
+    if (init_type != "gauss" && init_type != "gaussian" && init_type != "normal" && init_type != "uniform")
+    {
+        throw std::invalid_argument("Invalid init_type '" + init_type + "' for " + name);
+    }
+    return true;
+}
+
+/// ------------ BoolAttribute Definitions ------------///
 
+// Constructors
+/**
+ * @brief Construct a new Bool Attribute:: Bool Attribute object
+ *
+ * @param _name name of the Attribute
+ * @param _mutate_rate probability of mutating the value
+ */
+BoolAttribute::BoolAttribute(const std::string &_name,
+                             const float &_mutate_rate)
+{
+    spec = std::make_shared<AttributeSpec>(_name, _mutate_rate);
     value = rand_bool(_mutate_rate);
 }
 /**
@@ -34,11 +419,19 @@ BoolAttribute::BoolAttribute(const std::string &_name,
                              const bool &_default_value,
                              const float &_mutate_rate)
 {
-    name = _name;
-    mutate_rate = _mutate_rate;
+    spec = std::make_shared<AttributeSpec>(_name, _mutate_rate);
     value = _default_value;
-
-    validate();
+}
+/**
+ * @brief Construct a new Bool Attribute:: Bool Attribute object sharing a spec
+ *
+ * @param _spec
+ * @param _value
+ */
+BoolAttribute::BoolAttribute(AttributeSpec_ptr _spec, bool _value)
+{
+    spec = _spec;
+    value = _value;
 }
 
 // Getters
@@ -66,30 +459,24 @@ std::string BoolAttribute::get_string_value() { return value ? "true" : "false";
  *
  * @return float
  */
-float BoolAttribute::get_mutate_rate() { return mutate_rate; }
+float BoolAttribute::get_mutate_rate() { return spec->mutate_rate; }
 
 // Other Methods
 /**
- * @brief Creates a pointer to a new copy of this Attribute
+ * @brief Creates a pointer to a new copy of this Attribute, the copy shares the spec
  *
  * @return BoolAttribute*
  */
 Attribute_ptr BoolAttribute::copy()
 {
-    BoolAttribute_ptr ret_attr = std::make_shared<BoolAttribute>(name,
-                                                                 mutate_rate);
-    ret_attr->value = value;
-    return ret_attr;
+    return std::make_shared<BoolAttribute>(spec, value);
 }
 /**
  * @brief Mutates the Attribute's Value
  */
 void BoolAttribute::mutate_value()
 {
-    if (rand_bool(mutate_rate))
-    {
-        value = rand_bool(0.5);
-    }
+    value = spec->mutate_bool(value);
 }
 /**
  * @brief Provides a string detailing the class for debugging
@@ -98,9 +485,7 @@ void BoolAttribute::mutate_value()
  */
 std::string BoolAttribute::to_string()
 {
-    return "Bool Attribute: '" + name + "' with value " + std::to_string(value) +
-           "(mr: " + std::to_string(mutate_rate) +
-           ")";
+    return "Bool Attribute: '" + spec->name + "' with value " + std::to_string(value) + spec->to_string();
 }
 /**
  * @brief Validates the variables of the Attribute
@@ -110,15 +495,7 @@ std::string BoolAttribute::to_string()
  */
 bool BoolAttribute::validate()
 {
-    if (mutate_rate < 0)
-    {
-        throw(std::invalid_argument("Mutate Rate (" + std::to_string(mutate_rate) + ") must be greater than 0"));
-    }
-    else if (mutate_rate > 1.0F)
-    {
-        throw(std::invalid_argument("Mutate Rate (" + std::to_string(mutate_rate) + ") must be less than 1"));
-    }
-    return true;
+    return spec->validate();
 }
 
 /// ------------ IntAttribute Definitions ------------///
@@ -128,6 +505,9 @@ bool BoolAttribute::validate()
  * @brief Construct a new Int Attribute:: Int Attribute object
  *
  * @param _name Name of the Attribute
+ * @param _mean Mean Value of the Attribue
+ * @param _stdev Standard Deviation of Values
+ * @param _init_type gauss/gaussian/normal or uniform
  * @param _mutate_rate probability of mutating the value
  * @param _mutate_power Gaussian Standard deviation of mutations
  * @param _min_value Minimum value of the attribute
@@ -141,35 +521,29 @@ IntAttribute::IntAttribute(const std::string &_name,
                            const float &_mutate_power,
                            const int &_min_value,
                            const int &_max_value)
+    : IntAttribute(std::make_shared<AttributeSpec>(int_attribute, _name, _mean, _stdev, _init_type, _mutate_rate, _mutate_power, _min_value, _max_value))
 {
-    name = _name;
-    mean = _mean;
-    stdev = _stdev;
-    init_type = _init_type;
-    mutate_rate = _mutate_rate;
-    mutate_power = _mutate_power;
-    min_value = _min_value;
-    max_value = _max_value;
-
-    distribution = std::normal_distribution<float>(0, mutate_power);
-
-    validate();
-
-    if (!init_type.compare("gauss") || !init_type.compare("gaussian") || !init_type.compare("normal"))
-    {
-        std::normal_distribution<float> init_dist(mean, stdev);
-        value = static_cast<int>(init_dist(generator));
-    }
-    else if (!init_type.compare("uniform"))
-    {
-        std::uniform_int_distribution<int> init_dist(min_value, max_value);
-        value = init_dist(generator);
-    }
-    else
-    {
-        throw std::invalid_argument("Invalid init_type for Int Attribute");
-    }
-    value = std::clamp(value, min_value, max_value);
+}
+/**
+ * @brief Construct a new Int Attribute:: Int Attribute object with a value drawn from the spec
+ *
+ * @param _spec
+ */
+IntAttribute::IntAttribute(AttributeSpec_ptr _spec)
+{
+    spec = _spec;
+    value = spec->init_int();
+}
+/**
+ * @brief Construct a new Int Attribute:: Int Attribute object sharing a spec
+ *
+ * @param _spec
+ * @param _value
+ */
+IntAttribute::IntAttribute(AttributeSpec_ptr _spec, int _value)
+{
+    spec = _spec;
+    value = _value;
 }
 
 // Getters
@@ -197,57 +571,42 @@ std::string IntAttribute::get_string_value() { return std::to_string(value); }
  *
  * @return float
  */
-float IntAttribute::get_mutate_rate() { return mutate_rate; }
+float IntAttribute::get_mutate_rate() { return spec->mutate_rate; }
 /**
  * @brief Gets Mutate Power
  *
  * @return float
  */
-float IntAttribute::get_mutate_power() { return mutate_power; }
+float IntAttribute::get_mutate_power() { return spec->mutate_power; }
 /**
  * @brief Gets Minimum Value of Attribute
  *
  * @return int
  */
-int IntAttribute::get_min_value() { return min_value; }
+int IntAttribute::get_min_value() { return static_cast<int>(spec->min_value); }
 /**
  * @brief Gets Maximum Value of Attribute
  *
  * @return int
  */
-int IntAttribute::get_max_value() { return max_value; }
+int IntAttribute::get_max_value() { return static_cast<int>(spec->max_value); }
 
 // Other Methods
 /**
- * @brief Creates a pointer to a new copy of this Attribute
+ * @brief Creates a pointer to a new copy of this Attribute, the copy shares the spec
  *
  * @return IntAttribute*
  */
 Attribute_ptr IntAttribute::copy()
 {
-    IntAttribute_ptr ret_attr = std::make_shared<IntAttribute>(name,
-                                                               mean,
-                                                               stdev,
-                                                               init_type,
-                                                               mutate_rate,
-                                                               mutate_power,
-                                                               min_value,
-                                                               max_value);
-    ret_attr->value = value;
-    return ret_attr;
+    return std::make_shared<IntAttribute>(spec, value);
 }
 /**
  * @brief Randomly Mutates the Attribute's Value
- *
  */
 void IntAttribute::mutate_value()
 {
-    if (rand_bool(mutate_rate))
-    {
-        value += static_cast<int>(std::round(distribution(generator)));
-        value = (value < min_value) ? min_value : (max_value > value) ? value
-                                                                      : max_value;
-    }
+    value = spec->mutate_int(value);
 }
 /**
  * @brief Provides a string detailing the class for debugging
@@ -256,12 +615,7 @@ void IntAttribute::mutate_value()
  */
 std::string IntAttribute::to_string()
 {
-    return "Integer Attribute: '" + name + "' with value " + std::to_string(value) +
-           "(mr: " + std::to_string(mutate_rate) +
-           ", mp: " + std::to_string(mutate_power) +
-           ", min: " + std::to_string(min_value) +
-           ", max: " + std::to_string(max_value) +
-           ")";
+    return "Integer Attribute: '" + spec->name + "' with value " + std::to_string(value) + spec->to_string();
 }
 /**
  * @brief Validates the variables of the Attribute
@@ -271,47 +625,19 @@ std::string IntAttribute::to_string()
  */
 bool IntAttribute::validate()
 {
-    if (min_value > max_value)
-    {
-        throw(std::invalid_argument("Min Value: " + std::to_string(min_value) + " must be less than Max Value: " + std::to_string(max_value)));
-    }
-    if (mean > max_value)
-    {
-        throw(std::invalid_argument("Mean Value: " + std::to_string(mean) + " must be less than Max Value: " + std::to_string(max_value)));
-    }
-    if (mean < min_value)
-    {
-        throw(std::invalid_argument("Mean Value: " + std::to_string(mean) + " must be greater than Min Value: " + std::to_string(min_value)));
-    }
-    if (stdev < 0)
-    {
-        throw(std::invalid_argument("Standard Deviation (" + std::to_string(stdev) + ") must be greater than 0"));
-    }
-    if (mutate_rate < 0)
-    {
-        throw(std::invalid_argument("Mutate Rate (" + std::to_string(mutate_rate) + ") must be greater than 0"));
-    }
-    else if (mutate_rate > 1.0F)
-    {
-        throw(std::invalid_argument("Mutate Rate (" + std::to_string(mutate_rate) + ") must be less than 1"));
-    }
-    if (mutate_power < 0)
-    {
-        throw(std::invalid_argument("Mutate Power (" + std::to_string(mutate_rate) + ") must be greater than 0"));
-    }
-
-    return true;
+    return spec->validate();
 }
 
 /// ------------ FloatAttribute Definitions ------------///
 
 // Constructors
 /**
- * @brief Construct a new Int Attribute:: Int Attribute object
+ * @brief Construct a new Float Attribute:: Float Attribute object
  *
  * @param _name Name of the Attribute
  * @param _mean Mean Value of the Attribue
  * @param _stdev Standard Deviation of Values
+ * @param _init_type gauss/gaussian/normal or uniform
  * @param _mutate_rate probability of mutating the value
  * @param _mutate_power Gaussian Standard deviation of mutations
  * @param _min_value Minimum value of the attribute
@@ -325,36 +651,29 @@ FloatAttribute::FloatAttribute(const std::string &_name,
                                const float &_mutate_power,
                                const float &_min_value,
                                const float &_max_value)
+    : FloatAttribute(std::make_shared<AttributeSpec>(float_attribute, _name, _mean, _stdev, _init_type, _mutate_rate, _mutate_power, _min_value, _max_value))
 {
-    name = _name;
-    mean = _mean;
-    stdev = _stdev;
-    init_type = _init_type;
-    mutate_rate = _mutate_rate;
-    mutate_power = _mutate_power;
-    min_value = _min_value;
-    max_value = _max_value;
-
-    distribution = std::normal_distribution<float>(0, mutate_power);
-
-    validate();
-
-    if (!init_type.compare("gauss") || !init_type.compare("gaussian") || !init_type.compare("normal"))
-    {
-        std::normal_distribution<float> init_dist(mean, stdev);
-        value = init_dist(generator);
-    }
-    else if (!init_type.compare("uniform"))
-    {
-        std::uniform_real_distribution<float> init_dist(min_value, max_value);
-        value = init_dist(generator);
-    }
-    else
-    {
-        throw std::invalid_argument("Invalid init_type for Float Attribute");
-    }
-
-    value = std::clamp(value, min_value, max_value);
+}
+/**
+ * @brief Construct a new Float Attribute:: Float Attribute object with a value drawn from the spec
+ *
+ * @param _spec
+ */
+FloatAttribute::FloatAttribute(AttributeSpec_ptr _spec)
+{
+    spec = _spec;
+    value = spec->init_float();
+}
+/**
+ * @brief Construct a new Float Attribute:: Float Attribute object sharing a spec
+ *
+ * @param _spec
+ * @param _value
+ */
+FloatAttribute::FloatAttribute(AttributeSpec_ptr _spec, float _value)
+{
+    spec = _spec;
+    value = _value;
 }
 
 // Getters
@@ -363,7 +682,7 @@ FloatAttribute::FloatAttribute(const std::string &_name,
  *
  * @return float
  */
-float FloatAttribute::get_float_value() { return value; }
+float FloatAttribute::get_float_value() { return static_cast<float>(value); }
 /**
  * @brief Gets Bool Equivalent of Attribute's Value
  *
@@ -382,57 +701,42 @@ std::string FloatAttribute::get_string_value() { return std::to_string(value); }
  *
  * @return float
  */
-float FloatAttribute::get_mutate_rate() { return mutate_rate; }
+float FloatAttribute::get_mutate_rate() { return spec->mutate_rate; }
 /**
  * @brief Gets Mutate Power
  *
  * @return float
  */
-float FloatAttribute::get_mutate_power() { return mutate_power; }
+float FloatAttribute::get_mutate_power() { return spec->mutate_power; }
 /**
  * @brief Gets Minimum Value of Attribute
  *
  * @return float
  */
-float FloatAttribute::get_min_value() { return min_value; }
+float FloatAttribute::get_min_value() { return static_cast<float>(spec->min_value); }
 /**
  * @brief Gets Maximum Value of Attribute
  *
  * @return float
  */
-float FloatAttribute::get_max_value() { return max_value; }
+float FloatAttribute::get_max_value() { return static_cast<float>(spec->max_value); }
 
 // Other Methods
 /**
- * @brief Creates a pointer to a new copy of this Attribute
+ * @brief Creates a pointer to a new copy of this Attribute, the copy shares the spec
  *
  * @return FloatAttribute*
  */
 Attribute_ptr FloatAttribute::copy()
 {
-    FloatAttribute_ptr ret_attr = std::make_shared<FloatAttribute>(name,
-                                                                   mean,
-                                                                   stdev,
-                                                                   init_type,
-                                                                   mutate_rate,
-                                                                   mutate_power,
-                                                                   min_value,
-                                                                   max_value);
-    ret_attr->value = value;
-    return ret_attr;
+    return std::make_shared<FloatAttribute>(spec, value);
 }
 /**
  * @brief Randomly Mutates the Attribute's Value
  */
 void FloatAttribute::mutate_value()
 {
-    if (rand_bool(mutate_rate))
-    {
-
-        value += distribution(generator);
-        value = (value < min_value) ? min_value : (max_value > value) ? value
-                                                                      : max_value;
-    }
+    value = spec->mutate_float(value);
 }
 /**
  * @brief Provides a string detailing the class for debugging
@@ -441,12 +745,7 @@ void FloatAttribute::mutate_value()
  */
 std::string FloatAttribute::to_string()
 {
-    return "Float Attribute: '" + name + "' with value " + std::to_string(value) +
-           "(mr: " + std::to_string(mutate_rate) +
-           ", mp: " + std::to_string(mutate_power) +
-           ", min: " + std::to_string(min_value) +
-           ", max: " + std::to_string(max_value) +
-           ")";
+    return "Float Attribute: '" + spec->name + "' with value " + std::to_string(value) + spec->to_string();
 }
 /**
  * @brief Validates the variables of the Attribute
@@ -456,54 +755,46 @@ std::string FloatAttribute::to_string()
  */
 bool FloatAttribute::validate()
 {
-    if (min_value > max_value)
-    {
-        throw(std::invalid_argument("Min Value: " + std::to_string(min_value) + " must be less than Max Value: " + std::to_string(max_value)));
-    }
-    if (mean > max_value)
-    {
-        throw(std::invalid_argument("Mean Value: " + std::to_string(mean) + " must be less than Max Value: " + std::to_string(max_value)));
-    }
-    if (mean < min_value)
-    {
-        throw(std::invalid_argument("Mean Value: " + std::to_string(mean) + " must be greater than Min Value: " + std::to_string(min_value)));
-    }
-    if (stdev < 0)
-    {
-        throw(std::invalid_argument("Standard Deviation (" + std::to_string(stdev) + ") must be greater than 0"));
-    }
-    if (mutate_rate < 0)
-    {
-        throw(std::invalid_argument("Mutate Rate (" + std::to_string(mutate_rate) + ") must be greater than 0"));
-    }
-    else if (mutate_rate > 1.0F)
-    {
-        throw(std::invalid_argument("Mutate Rate (" + std::to_string(mutate_rate) + ") must be less than 1"));
-    }
-    if (mutate_power < 0)
-    {
-        throw(std::invalid_argument("Mutate Power (" + std::to_string(mutate_rate) + ") must be greater than 0"));
-    }
-    return true;
+    return spec->validate();
 }
 
+/// ------------ StringAttribute Definitions ------------///
+
+/**
+ * @brief Construct a new String Attribute:: String Attribute object with a random option
+ *
+ * @param _name name of the Attribute
+ * @param _mutate_rate probability of mutating the value
+ * @param _options options the value is chosen from
+ */
 StringAttribute::StringAttribute(const std::string &_name, const float &_mutate_rate, const std::set<std::string> &_options)
+    : StringAttribute(std::make_shared<AttributeSpec>(_name, _mutate_rate, OptionSet::intern(_options)))
 {
-    name = _name;
-    mutate_rate = _mutate_rate;
-    options = _options;
-    distribution = std::uniform_int_distribution<int>(0, options.size() - 1);
-
-    validate();
+}
 
-    value = random_option();
+/**
+ * @brief Construct a new String Attribute:: String Attribute object with a random option of the spec
+ *
+ * @param _spec
+ */
+StringAttribute::StringAttribute(AttributeSpec_ptr _spec)
+{
+    spec = _spec;
+    value_id = spec->init_option();
 }
 
-std::string StringAttribute::random_option()
+/**
+ * @brief Construct a new String Attribute:: String Attribute object sharing a spec
+ *
+ * @param _spec
+ * @param _value_id index of the value in the spec's options
+ */
+StringAttribute::StringAttribute(AttributeSpec_ptr _spec, int _value_id)
 {
-    std::set<std::string>::iterator it = options.begin();
-    std::advance(it, distribution(generator));
-    return *it;
+    spec = _spec;
+    value_id = _value_id;
+
+    validate();
 }
 
 float StringAttribute::get_float_value()
@@ -511,7 +802,7 @@ float StringAttribute::get_float_value()
     float fl;
     try
     {
-        fl = std::stof(value);
+        fl = std::stof(spec->options->at(value_id));
     }
     catch (std::invalid_argument)
     {
@@ -521,66 +812,56 @@ float StringAttribute::get_float_value()
 }
 bool StringAttribute::get_bool_value()
 {
-    return value != "";
+    return spec->options->at(value_id) != "";
 }
 std::string StringAttribute::get_string_value()
 {
-    return value;
+    return spec->options->at(value_id);
 }
 float StringAttribute::get_mutate_rate()
 {
-    return mutate_rate;
+    return spec->mutate_rate;
+}
+OptionSet_ptr StringAttribute::get_options()
+{
+    return spec->options;
 }
-std::set<std::string> StringAttribute::get_options()
+/**
+ * @brief Whether both attributes hold the same option, attributes sharing an
+ * OptionSet are compared by index only
+ *
+ * @param other
+ * @return true
+ * @return false
+ */
+bool StringAttribute::same_value(const StringAttribute &other) const
 {
-    return options;
+    if (spec->options == other.spec->options)
+    {
+        return value_id == other.value_id;
+    }
+    return spec->options->at(value_id) == other.spec->options->at(other.value_id);
 }
 
 Attribute_ptr StringAttribute::copy()
 {
-    StringAttribute_ptr ret_attr = std::make_shared<StringAttribute>(name,
-                                                                     mutate_rate,
-                                                                     options);
-
-    ret_attr->value = value;
-
-    return ret_attr;
+    return std::make_shared<StringAttribute>(spec, value_id);
 }
 void StringAttribute::mutate_value()
 {
-    if (rand_bool(mutate_rate))
-    {
-        value = random_option();
-    }
+    value_id = spec->mutate_option(value_id);
 }
 std::string StringAttribute::to_string()
 {
-    std::string ret_str = "String Attribute: '" + name + "' with value '" + value +
-                          "' (mr: " + std::to_string(mutate_rate) +
-                          ", options: [";
-    for (std::string op : options)
-    {
-        ret_str += (op + ", ");
-    }
-    ret_str += "])";
-
-    return ret_str;
+    return "String Attribute: '" + spec->name + "' with value '" + spec->options->at(value_id) + "' " + spec->to_string();
 }
 
 bool StringAttribute::validate()
 {
-    if (mutate_rate < 0)
-    {
-        throw(std::invalid_argument("Mutate Rate (" + std::to_string(mutate_rate) + ") must be greater than 0"));
-    }
-    else if (mutate_rate > 1.0F)
-    {
-        throw(std::invalid_argument("Mutate Rate (" + std::to_string(mutate_rate) + ") must be less than 1"));
-    }
-
-    if (options.size() <= 0)
+    spec->validate();
+    if (value_id < 0 || value_id >= spec->options->size())
     {
-        throw(std::invalid_argument("You must provide at least 1 option to a StringAttribute"));
+        throw(std::invalid_argument("Value id (" + std::to_string(value_id) + ") is not an option of the StringAttribute"));
     }
     return true;
-}
\ No newline at end of file
+}
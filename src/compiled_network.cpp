@@ -0,0 +1,533 @@
+#include "compiled_network.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <stdexcept>
+#include <filesystem>
+#include <system_error>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <dlfcn.h>
+#include <unistd.h>
+#include <spawn.h>
+#include <pwd.h>
+#include <sys/wait.h>
+#include <sys/stat.h>
+
+extern char **environ;
+
+// Compiler flags of the generated code, contraction is disabled so the generated code rounds like FeedForwardNetwork
+static const std::vector<std::string> compile_flags = {"-O2", "-shared", "-fPIC", "-ffp-contract=off"};
+
+// Definitions the generated code uses, these mirror the exact activations in activations.h
+static const std::string generated_preamble = R"(// Generated by neat-cpp from a FeedForwardNetwork, do not edit
+#include <cmath>
+#include <algorithm>
+
+static inline float linear_act(float x) { return x; }
+static inline float sigmoid_act(float x) { return 1.0F / (1.0F + std::exp(-x)); }
+static inline float tanh_act(float x) { return std::tanh(x); }
+static inline float sin_act(float x) { return std::sin(x); }
+static inline float gauss_act(float x) { return std::exp(std::pow(x, 2)); }
+static inline float relu_act(float x) { return x > 0 ? x : 0.F; }
+static inline float softplus_act(float x) { return std::log1p(std::exp(x)); }
+static inline float clamped_act(float x) { return (x > 1.F) ? 1.F : (x < -1.F) ? -1.F : x; }
+static inline float abs_act(float x) { return std::fabs(x); }
+static inline float square_act(float x) { return std::pow(x, 2); }
+static inline float cubed_act(float x) { return std::pow(x, 3); }
+
+static inline float median_agg(float *values, int n)
+{
+    std::sort(values, values + n);
+    return (n % 2 == 0) ? (values[n / 2 - 1] + values[n / 2]) * 0.5F : values[n / 2];
+}
+
+)";
+
+/**
+ * @brief formats the float as a hexadecimal literal so the constant is reproduced exactly
+ *
+ * @param value
+ * @return std::string
+ */
+static std::string float_literal(float value)
+{
+    if (std::isnan(value))
+    {
+        return "__builtin_nanf(\"\")";
+    }
+    if (std::isinf(value))
+    {
+        return (value > 0) ? "__builtin_inff()" : "(-__builtin_inff())";
+    }
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), "%aF", static_cast<double>(value));
+    return buffer;
+}
+
+/**
+ * @brief 64 bit FNV-1a hash of text
+ *
+ * @param text
+ * @return std::string hash as 16 hex digits
+ */
+static std::string content_hash(const std::string &text)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : text)
+    {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    char buffer[17];
+    std::snprintf(buffer, sizeof(buffer), "%016llx", static_cast<unsigned long long>(hash));
+    return buffer;
+}
+
+/**
+ * @brief splits a command on whitespace, so a compiler like "ccache g++" becomes two arguments
+ *
+ * @param command
+ * @return std::vector<std::string>
+ */
+static std::vector<std::string> split_command(const std::string &command)
+{
+    std::vector<std::string> args;
+    std::istringstream stream(command);
+    std::string arg;
+    while (stream >> arg)
+    {
+        args.push_back(arg);
+    }
+    return args;
+}
+
+/**
+ * @brief joins arguments with spaces for error messages
+ *
+ * @param args
+ * @return std::string
+ */
+static std::string join_command(const std::vector<std::string> &args)
+{
+    std::string command;
+    for (const std::string &arg : args)
+    {
+        command += (command.empty() ? "" : " ") + arg;
+    }
+    return command;
+}
+
+/**
+ * @brief runs a program directly, without a shell, so arguments never need quoting
+ *
+ * @param args program followed by its arguments, the program is looked up in PATH
+ * @param output if not null receives everything the program writes to standard output
+ * @return int exit status of the program, -1 if it could not be run
+ */
+static int run_program(const std::vector<std::string> &args, std::string *output)
+{
+    if (args.empty())
+    {
+        return -1;
+    }
+    std::vector<char *> argv;
+    for (const std::string &arg : args)
+    {
+        argv.push_back(const_cast<char *>(arg.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    int pipe_fds[2] = {-1, -1};
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    if (output != nullptr)
+    {
+        if (pipe(pipe_fds) != 0)
+        {
+            posix_spawn_file_actions_destroy(&actions);
+            return -1;
+        }
+        posix_spawn_file_actions_adddup2(&actions, pipe_fds[1], STDOUT_FILENO);
+        posix_spawn_file_actions_addclose(&actions, pipe_fds[0]);
+        posix_spawn_file_actions_addclose(&actions, pipe_fds[1]);
+    }
+    pid_t pid;
+    const int error = posix_spawnp(&pid, argv[0], &actions, nullptr, argv.data(), environ);
+    posix_spawn_file_actions_destroy(&actions);
+    if (output != nullptr)
+    {
+        close(pipe_fds[1]);
+        char buffer[256];
+        ssize_t count;
+        while (error == 0 && (count = read(pipe_fds[0], buffer, sizeof(buffer))) != 0)
+        {
+            if (count > 0)
+            {
+                output->append(buffer, count);
+            }
+            else if (errno != EINTR)
+            {
+                break;
+            }
+        }
+        close(pipe_fds[0]);
+    }
+    if (error != 0)
+    {
+        return -1;
+    }
+    int status;
+    while (waitpid(pid, &status, 0) < 0)
+    {
+        if (errno != EINTR)
+        {
+            return -1;
+        }
+    }
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+/**
+ * @brief what the compiler reports from --version, queried once per compiler and process
+ * Part of the cache key so upgrading or switching the compiler doesn't reuse old libraries
+ *
+ * @param compiler
+ * @return std::string
+ */
+static std::string compiler_identity(const std::string &compiler)
+{
+    static std::mutex mutex;
+    static std::map<std::string, std::string> identities;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::map<std::string, std::string>::iterator it = identities.find(compiler);
+    if (it == identities.end())
+    {
+        std::vector<std::string> args = split_command(compiler);
+        args.push_back("--version");
+        std::string version;
+        run_program(args, &version);
+        it = identities.emplace(compiler, version).first;
+    }
+    return it->second;
+}
+
+/**
+ * @brief creates the cache directory if it doesn't exist, readable and writable only by the current user
+ *
+ * @param dir
+ */
+static void create_cache_directory(const std::filesystem::path &dir)
+{
+    if (std::filesystem::exists(dir))
+    {
+        return;
+    }
+    std::error_code ec;
+    if (dir.has_parent_path())
+    {
+        std::filesystem::create_directories(dir.parent_path(), ec);
+    }
+    if (ec || (mkdir(dir.c_str(), 0700) != 0 && errno != EEXIST))
+    {
+        throw std::runtime_error("Could not create network cache directory '" + dir.string() + "'");
+    }
+}
+
+/**
+ * @brief throws unless path is owned by the current user and not writable by group or others
+ * Anyone else able to write a cached library could get code loaded into this process
+ *
+ * @param path
+ * @param directory whether path is the cache directory, the library itself must not be a symlink
+ */
+static void check_private(const std::filesystem::path &path, bool directory)
+{
+    struct stat info;
+    if ((directory ? stat(path.c_str(), &info) : lstat(path.c_str(), &info)) != 0)
+    {
+        throw std::runtime_error("Could not inspect '" + path.string() + "': " + std::strerror(errno));
+    }
+    if ((directory ? !S_ISDIR(info.st_mode) : !S_ISREG(info.st_mode)) ||
+        info.st_uid != geteuid() || (info.st_mode & (S_IWGRP | S_IWOTH)) != 0)
+    {
+        throw std::runtime_error("Refusing to use '" + path.string() +
+                                 "', it must be owned by the current user and not writable by others");
+    }
+}
+
+/**
+ * @brief emits straight-line C++ computing the network
+ * Defines extern "C" void neat_forward(const float *inputs, float *outputs)
+ *
+ * @param network
+ * @return std::string
+ */
+std::string CompiledNetwork::generate_source(const FeedForwardNetwork &network)
+{
+    std::ostringstream src;
+    src << generated_preamble;
+    src << "extern \"C\" int neat_num_inputs() { return " << network.num_inputs << "; }\n";
+    src << "extern \"C\" int neat_num_outputs() { return " << network.num_outputs << "; }\n\n";
+    src << "extern \"C\" void neat_forward(const float *inputs, float *outputs)\n{\n";
+
+    for (int in = 0; in < network.num_inputs; in++)
+    {
+        src << "    const float v" << in << " = inputs[" << in << "];\n";
+    }
+
+    const int num_evaluated = network.num_nodes - network.num_inputs;
+    for (int i = 0; i < num_evaluated; i++)
+    {
+        const int first_edge = network.edge_offsets[i];
+        const int last_edge = network.edge_offsets[i + 1];
+        const int fan_in = last_edge - first_edge;
+        const valid_aggregations aggregation = network.node_aggregation[i];
+
+        // weighted inputs in the order FeedForwardNetwork folds them
+        std::vector<std::string> terms;
+        for (int e = first_edge; e < last_edge; e++)
+        {
+            terms.push_back("v" + std::to_string(network.edge_sources[e]) + " * " + float_literal(network.edge_weights[e]));
+        }
+
+        std::string agg;
+        if (fan_in == 0)
+        {
+            agg = "0.0F";
+        }
+        else if (aggregation == valid_aggregations::median)
+        {
+            std::string values = "";
+            for (const std::string &term : terms)
+            {
+                values += (values.empty() ? "" : ", ") + term;
+            }
+            src << "    float m" << i << "[] = {" << values << "};\n";
+            agg = "median_agg(m" + std::to_string(i) + ", " + std::to_string(fan_in) + ")";
+        }
+        else if (aggregation == valid_aggregations::max || aggregation == valid_aggregations::min)
+        {
+            const std::string fold = (aggregation == valid_aggregations::max) ? "std::max" : "std::min";
+            agg = terms[0];
+            for (int t = 1; t < fan_in; t++)
+            {
+                agg = fold + "(" + agg + ", " + terms[t] + ")";
+            }
+        }
+        else
+        {
+            agg = "0.0F";
+            for (const std::string &term : terms)
+            {
+                agg += " + " + term;
+            }
+            if (aggregation == valid_aggregations::mean)
+            {
+                agg = "(" + agg + ") / " + float_literal(static_cast<float>(fan_in));
+            }
+        }
+
+        src << "    const float v" << network.num_inputs + i << " = " << activation_name(network.node_activation[i]) + "_act"
+            << "(" << float_literal(network.node_bias[i]) << " + " << float_literal(network.node_response[i])
+            << " * (" << agg << "));\n";
+    }
+
+    for (int o = 0; o < network.num_outputs; o++)
+    {
+        src << "    outputs[" << o << "] = v" << network.output_indices[o] << ";\n";
+    }
+    src << "}\n";
+    return src.str();
+}
+
+/**
+ * @brief directory compiled networks are cached in
+ * NEAT_CACHE_DIR if set, otherwise neat-cpp in the user's cache directory ($XDG_CACHE_HOME or ~/.cache)
+ *
+ * @return std::string
+ */
+std::string CompiledNetwork::default_cache_dir()
+{
+    const char *dir = std::getenv("NEAT_CACHE_DIR");
+    if (dir != nullptr && dir[0] != '\0')
+    {
+        return dir;
+    }
+    const char *xdg_cache = std::getenv("XDG_CACHE_HOME");
+    if (xdg_cache != nullptr && xdg_cache[0] == '/')
+    {
+        return (std::filesystem::path(xdg_cache) / "neat-cpp").string();
+    }
+    const char *home = std::getenv("HOME");
+    if (home == nullptr || home[0] == '\0')
+    {
+        const passwd *user = getpwuid(geteuid());
+        home = (user != nullptr) ? user->pw_dir : nullptr;
+    }
+    if (home == nullptr || home[0] == '\0')
+    {
+        throw std::runtime_error("No cache directory for compiled networks, set NEAT_CACHE_DIR or HOME");
+    }
+    return (std::filesystem::path(home) / ".cache" / "neat-cpp").string();
+}
+
+/**
+ * @brief compiler used for the generated code, CXX if set
+ *
+ * @return std::string
+ */
+std::string CompiledNetwork::default_compiler()
+{
+    const char *cxx = std::getenv("CXX");
+    if (cxx != nullptr && cxx[0] != '\0')
+    {
+        return cxx;
+    }
+    return "c++";
+}
+
+/**
+ * @brief Construct a new Compiled Network object, caching in the default directory
+ *
+ * @param network
+ */
+CompiledNetwork::CompiledNetwork(const FeedForwardNetwork &network)
+    : CompiledNetwork(network, default_cache_dir(), default_compiler())
+{
+}
+
+/**
+ * @brief Construct a new Compiled Network object
+ * Loads the cached shared object for the network, compiling it first if it isn't cached yet
+ *
+ * @param network
+ * @param cache_dir directory the generated sources and shared objects are kept in
+ * @param compiler command used to compile the generated source
+ */
+CompiledNetwork::CompiledNetwork(const FeedForwardNetwork &network, const std::string &cache_dir, const std::string &compiler)
+{
+    num_inputs = network.num_inputs;
+    num_outputs = network.num_outputs;
+    handle = nullptr;
+    forward_fn = nullptr;
+
+    const std::string source = generate_source(network);
+    const std::string hash = content_hash(compiler + "\n" + compiler_identity(compiler) + "\n" +
+                                          join_command(compile_flags) + "\n" + source);
+    std::filesystem::path dir(cache_dir);
+    if (!dir.has_filename())
+    {
+        dir = dir.parent_path();
+    }
+    library_path = (dir / ("neat_" + hash + ".so")).string();
+
+    create_cache_directory(dir);
+    check_private(dir, true);
+    if (!std::filesystem::exists(library_path))
+    {
+        std::error_code ec;
+        // build under a name unique to the process and the build and rename, so concurrent builds
+        // of the same network, in this process or another, never write to or load a partial file
+        static std::atomic<unsigned long> build_count(0);
+        const std::string tmp_name = "neat_" + hash + "." + std::to_string(getpid()) + "." + std::to_string(build_count++);
+        const std::string source_path = (dir / (tmp_name + ".cpp")).string();
+        const std::string tmp_library_path = (dir / (tmp_name + ".so")).string();
+        std::ofstream source_file(source_path);
+        source_file << source;
+        source_file.close();
+        if (!source_file)
+        {
+            throw std::runtime_error("Could not write generated network source '" + source_path + "'");
+        }
+
+        std::vector<std::string> command = split_command(compiler);
+        command.insert(command.end(), compile_flags.begin(), compile_flags.end());
+        command.insert(command.end(), {"-o", tmp_library_path, source_path});
+        const int status = run_program(command, nullptr);
+        std::filesystem::remove(source_path, ec);
+        if (status != 0)
+        {
+            std::filesystem::remove(tmp_library_path, ec);
+            throw std::runtime_error("Compiling the generated network failed: " + join_command(command));
+        }
+        // the compiler applies the umask, which may leave the library writable by the group
+        std::filesystem::permissions(tmp_library_path, std::filesystem::perms::group_write | std::filesystem::perms::others_write,
+                                     std::filesystem::perm_options::remove, ec);
+        std::filesystem::rename(tmp_library_path, library_path, ec);
+        if (ec)
+        {
+            std::filesystem::remove(tmp_library_path, ec);
+            throw std::runtime_error("Could not move compiled network to '" + library_path + "'");
+        }
+    }
+
+    check_private(library_path, false);
+    handle = dlopen(library_path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (handle == nullptr)
+    {
+        throw std::runtime_error("Could not load compiled network: " + std::string(dlerror()));
+    }
+    typedef int (*count_function)();
+    count_function loaded_inputs = reinterpret_cast<count_function>(dlsym(handle, "neat_num_inputs"));
+    count_function loaded_outputs = reinterpret_cast<count_function>(dlsym(handle, "neat_num_outputs"));
+    forward_fn = reinterpret_cast<forward_function>(dlsym(handle, "neat_forward"));
+    if (loaded_inputs == nullptr || loaded_outputs == nullptr || forward_fn == nullptr ||
+        loaded_inputs() != num_inputs || loaded_outputs() != num_outputs)
+    {
+        dlclose(handle);
+        throw std::runtime_error("Compiled network '" + library_path + "' does not match the network");
+    }
+}
+
+CompiledNetwork::~CompiledNetwork()
+{
+    if (handle != nullptr)
+    {
+        dlclose(handle);
+    }
+}
+
+int CompiledNetwork::get_num_inputs() const
+{
+    return num_inputs;
+}
+
+int CompiledNetwork::get_num_outputs() const
+{
+    return num_outputs;
+}
+
+std::string CompiledNetwork::get_library_path() const
+{
+    return library_path;
+}
+
+/**
+ * @brief computes the result of providing the given inputs to the compiled network
+ *
+ * @param inputs
+ * @return std::vector<float>
+ */
+std::vector<float> CompiledNetwork::forward(std::vector<float> inputs) const
+{
+    if (inputs.size() != static_cast<size_t>(num_inputs))
+    {
+        throw std::invalid_argument("Incorrect number of inputs provided, given: " +
+                                    std::to_string(inputs.size()) +
+                                    ", need: " +
+                                    std::to_string(num_inputs));
+    }
+    std::vector<float> outputs(num_outputs);
+    forward_fn(inputs.data(), outputs.data());
+    return outputs;
+}
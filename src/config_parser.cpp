@@ -5,6 +5,7 @@
 #include <sstream>
 #include <iostream>
 #include <map>
+#include <algorithm>
 
 ConfigParser::ConfigParser(std::string fname)
 {
@@ -273,6 +274,18 @@ float SpecialConfig::get_value<float>(const std::string _str)
     }
 }
 
+/**
+ * @brief checks whether a value was provided for the key, used for optional keys
+ *
+ * @param _str
+ * @return true
+ * @return false
+ */
+bool SpecialConfig::has_value(const std::string _str)
+{
+    return data.count(_str) > 0;
+}
+
 // Helper function for automatic type deduction
 template <typename T>
 T get_value(const std::string _str)
@@ -1,181 +1,94 @@
 #include "genes.h"
 
-#include <map>
-#include <iostream>
+#include <cmath>
+#include <array>
+#include <string>
 #include <vector>
+#include <random>
 #include <utility>
+#include <algorithm>
+#include <stdexcept>
 #include "attributes.h"
+#include "genome.h"
+#include "random_generator.h"
 
-/// ------------ Gene Definitions ------------///
 /**
- * @brief Mutates all attributes for this gene
+ * @brief picks one of options uniformly at random
  *
+ * @param options
+ * @return T
  */
-void Gene::mutate()
+template <typename T>
+static T random_option(const std::vector<T> &options)
 {
-    for (std::pair<const std::string, Attribute_ptr> &at : attributes)
-    {
-        at.second->mutate_value();
-    }
+    std::uniform_int_distribution<int> distribution(0, options.size() - 1);
+    return options[distribution(generator)];
 }
-/**
- * @brief Checks whether Gene has attribute
- *
- * @param _key
- * @return true
- * @return false
- */
-bool Gene::has_attribute(std::string _key)
-{
-    return static_cast<bool>(attributes.count(_key));
-}
-/**
- * @brief Verifies the Gene has _key attribute and it is _type
- *
- * @param _key
- * @param _type
- * @return true
- * @return false
- */
-bool Gene::verify_ind_attribute(std::string _key, std::string _type)
-{
-    if (!this->has_attribute(_key))
-    {
-        throw std::invalid_argument("Attributes must contain a '" + _key + "' Attribute");
-    }
 
-    switch (type_map[_type])
-    {
-    case float_attribute:
-        if (std::dynamic_pointer_cast<FloatAttribute>(attributes[_key]) == nullptr)
-        {
-            throw std::invalid_argument("Attribute '" + _key + "' must be of type '" + _type + "'");
-        }
-        break;
-    case int_attribute:
-        if (std::dynamic_pointer_cast<IntAttribute>(attributes[_key]) == nullptr)
-        {
-            throw std::invalid_argument("Attribute '" + _key + "' must be of type '" + _type + "'");
-        }
-        break;
-    case bool_attribute:
-        if (std::dynamic_pointer_cast<BoolAttribute>(attributes[_key]) == nullptr)
-        {
-            throw std::invalid_argument("Attribute '" + _key + "' must be of type '" + _type + "'");
-        }
-        break;
-    case string_attribute:
-        if (std::dynamic_pointer_cast<StringAttribute>(attributes[_key]) == nullptr)
-        {
-            throw std::invalid_argument("Attribute '" + _key + "' must be of type '" + _type + "'");
-        }
-        break;
-    default:
-        throw std::invalid_argument("Invalid Attribute Type '" + _type + "' Requested for Attribute'" + _key + "'");
-        break;
-    }
-    return true;
-}
 /**
- * @brief Verifies Gene has _key attribute and it is one of _types
+ * @brief Mutates one float member of every gene with spec, through a contiguous copy of
+ * the values so spec perturbs them in a single pass
  *
- * @param _key
- * @param _types
- * @return true
- * @return false
+ * @tparam Gene
+ * @param genes
+ * @param member
+ * @param spec
  */
-bool Gene::verify_ind_attribute(std::string _key, std::vector<std::string> _types)
+template <typename Gene>
+static void mutate_member(std::span<Gene> genes, float Gene::*member, const AttributeSpec &spec)
 {
-    if (!(this->has_attribute(_key)))
-    {
-        throw std::invalid_argument("Attributes must contain a '" + _key + "' Attribute");
-    }
-
-    bool correct_type = false;
-    for (std::string _type : _types)
+    std::array<float, AttributeSpec::mutate_batch> values;
+    for (size_t start = 0; start < genes.size(); start += values.size())
     {
-        switch (type_map[_type])
-        {
-        case float_attribute:
-            if (std::dynamic_pointer_cast<FloatAttribute>(attributes[_key]) != nullptr)
-            {
-                correct_type = true;
-            }
-            break;
-        case int_attribute:
-            if (std::dynamic_pointer_cast<IntAttribute>(attributes[_key]) != nullptr)
-            {
-                correct_type = true;
-            }
-            break;
-        case bool_attribute:
-            if (std::dynamic_pointer_cast<BoolAttribute>(attributes[_key]) != nullptr)
-            {
-                correct_type = true;
-            }
-            break;
-        case string_attribute:
-            if (std::dynamic_pointer_cast<StringAttribute>(attributes[_key]) != nullptr)
-            {
-                correct_type = true;
-            }
-            break;
-        default:
-            throw std::invalid_argument("Invalid Attribute Type '" + _type + "' Requested for Attribute'" + _key + "'");
-            break;
-        }
-        if (correct_type)
+        const size_t count = std::min(values.size(), genes.size() - start);
+        for (size_t i = 0; i < count; i++)
         {
-            break;
+            values[i] = genes[start + i].*member;
         }
-    }
-    if (!correct_type)
-    {
-        std::string err_msg = "Attribute '" + _key + "' must be one of type [";
-        for (int i = 0; i < _types.size(); i++)
+        spec.mutate_floats(std::span<float>(values.data(), count));
+        for (size_t i = 0; i < count; i++)
         {
-            err_msg += (" '" + _types[i] + "'");
+            genes[start + i].*member = values[i];
         }
-        err_msg += "]";
-        std::invalid_argument(err_msg.c_str());
     }
-    return false;
 }
+
+/// ------------ NodeGene Definitions ------------///
+
+// Constructors
 /**
- * @brief Gets Pointer to Attribute with given key
+ * @brief Construct a new Node Gene:: Node Gene object with the given values
  *
  * @param _key
- * @return Attribute*
+ * @param _bias
+ * @param _response
+ * @param _activation
+ * @param _aggregation
+ * @param _time_constant only used by CTRNNs
  */
-Attribute_ptr Gene::get_attribute(std::string _key)
+NodeGene::NodeGene(int _key, float _bias, float _response, valid_activations _activation, valid_aggregations _aggregation, float _time_constant)
 {
-    if (this->has_attribute(_key))
-    {
-        return attributes[_key];
-    }
-    else
-    {
-        throw std::invalid_argument("Could not find attribute '" + _key + "' in Gene");
-    }
+    key = _key;
+    bias = _bias;
+    response = _response;
+    time_constant = _time_constant;
+    activation = _activation;
+    aggregation = _aggregation;
 }
-/// ------------ NodeGene Definitions ------------///
-
-// Constructors
 /**
- * @brief Construct a new Node Gene:: Node Gene object
+ * @brief Construct a new Node Gene:: Node Gene object with values drawn from the config
  *
  * @param _key
- * @param _attributes
+ * @param config
  */
-NodeGene::NodeGene(int _key, std::vector<Attribute_ptr> _attributes)
+NodeGene::NodeGene(int _key, const GenomeConfig &config)
 {
     key = _key;
-    for (int i = 0; i < _attributes.size(); i++)
-    {
-        attributes[_attributes[i]->name] = _attributes[i];
-    }
-
-    verify_attributes();
+    bias = config.bias_spec->init_float();
+    response = config.response_spec->init_float();
+    activation = random_option(config.activation_ids);
+    aggregation = random_option(config.aggregation_ids);
+    time_constant = config.time_constant_spec->init_float();
 }
 
 // Other Functions
@@ -185,137 +98,119 @@ NodeGene::NodeGene(int _key, std::vector<Attribute_ptr> _attributes)
  * @param other
  * @return float
  */
-float NodeGene::distance(NodeGene_ptr &other, float compatability_weight)
+float NodeGene::distance(const NodeGene &other, float compatability_weight) const
 {
-    // Get Values of Each Attribute
-    float bias = attributes["bias"]->get_float_value();
-    float response = attributes["response"]->get_float_value();
-    std::string activation = attributes["activation"]->get_string_value();
-    std::string aggregation = attributes["aggregation"]->get_string_value();
-
-    float bias_other = other->attributes["bias"]->get_float_value();
-    float response_other = other->attributes["response"]->get_float_value();
-    std::string activation_other = other->attributes["activation"]->get_string_value();
-    std::string aggregation_other = other->attributes["aggregation"]->get_string_value();
-
-    // Calculate Distance between the
-    float dist = std::fabs(bias - bias_other) + std::fabs(response - response_other);
-    dist += (activation.compare(activation_other) ? 1.0F : 0.0F);
-    dist += (aggregation.compare(aggregation_other) ? 1.0F : 0.0F);
+    float dist = std::fabs(bias - other.bias) + std::fabs(response - other.response);
+    dist += (activation != other.activation) ? 1.0F : 0.0F;
+    dist += (aggregation != other.aggregation) ? 1.0F : 0.0F;
+    dist += std::fabs(time_constant - other.time_constant);
     return dist * compatability_weight;
 }
 /**
- * @brief Creates a pointer to a new copy of this NodeGene
- *
- * @return NodeGene*
- */
-NodeGene_ptr NodeGene::copy()
-{
-    std::vector<Attribute_ptr> attributes_copy;
-    attributes_copy.reserve(attributes.size());
-    for (std::map<std::string, Attribute_ptr>::iterator it = attributes.begin(); it != attributes.end(); it++)
-    {
-        Attribute_ptr new_attr = (it->second)->copy();
-        attributes_copy.push_back(new_attr);
-    }
-    return std::make_shared<NodeGene>(key, attributes_copy);
-}
-/**
- * @brief Creates an std::make_shared<NodeGene>  with a mix of attributes between each gene
+ * @brief Creates a new NodeGene inheriting each value from a random parent
  *
- * @return NodeGene*
+ * @return NodeGene
  */
-NodeGene_ptr NodeGene::crossover(NodeGene_ptr &gene2)
+NodeGene NodeGene::crossover(const NodeGene &gene2) const
 {
-    if (key != gene2->key)
+    if (key != gene2.key)
     {
         throw std::invalid_argument("Invalid Crossover between NodeGeene: " +
                                     std::to_string(key) + ", " +
-                                    std::to_string(gene2->key));
+                                    std::to_string(gene2.key));
     }
 
-    std::vector<Attribute_ptr> attributes_copy;
-    attributes_copy.reserve(std::max(attributes.size(), gene2->attributes.size()));
-    // Find all
-    for (std::map<std::string, Attribute_ptr>::iterator it = attributes.begin(); it != attributes.end(); it++)
+    NodeGene child = *this;
+    if (rand_bool(0.5))
     {
-        Attribute_ptr new_attr;
-        // If the Attribute is shared between the genes then randomly pick one of the parents to inherit from
-        if (gene2->has_attribute(it->first))
-        {
-            if (rand_bool(0.5))
-            {
-                new_attr = gene2->attributes[it->first]->copy();
-            }
-            else
-            {
-                new_attr = (it->second)->copy();
-            }
-            attributes_copy.push_back(new_attr);
-        }
+        child.bias = gene2.bias;
     }
-
-    return std::make_shared<NodeGene>(key, attributes_copy);
+    if (rand_bool(0.5))
+    {
+        child.response = gene2.response;
+    }
+    if (rand_bool(0.5))
+    {
+        child.activation = gene2.activation;
+    }
+    if (rand_bool(0.5))
+    {
+        child.aggregation = gene2.aggregation;
+    }
+    if (rand_bool(0.5))
+    {
+        child.time_constant = gene2.time_constant;
+    }
+    return child;
 }
 /**
- * @brief Generates a printable string for this Gene
+ * @brief Mutates every value of this gene with the rates in config
  *
- * @return std::string
+ * @param config
  */
-std::string NodeGene::to_string()
+void NodeGene::mutate(const GenomeConfig &config)
 {
-    std::string ret_str = "NodeGene '" + std::to_string(key) + "'";
-    for (std::map<std::string, Attribute_ptr>::iterator it = attributes.begin(); it != attributes.end(); it++)
-    {
-        ret_str = ret_str + "\n\t" + (it->second)->to_string();
-    }
-    return ret_str;
+    mutate_all(std::span<NodeGene>(this, 1), config);
 }
 /**
- * @brief Verify All Attributes are valid
+ * @brief Mutates every gene like mutate, each float value of all genes at once
+ *
+ * @param genes contiguous genes, e.g. a block of a GeneVector
+ * @param config
  */
-void NodeGene::verify_attributes()
+void NodeGene::mutate_all(std::span<NodeGene> genes, const GenomeConfig &config)
 {
-    // Check whether FloatAttribute/IntAttribute 'Bias' is in Gene
-    std::vector<std::string> bias_types = {"FloatAttribute", "IntAttribute"};
-    verify_ind_attribute("bias", bias_types);
-
-    // Check whether FloatAttribute/IntAttribute 'Response' is in Gene
-    std::vector<std::string> resp_types = {"FloatAttribute", "IntAttribute"};
-    verify_ind_attribute("response", resp_types);
-
-    // Check whether StringAttribute 'Activation' is in Gene
-    std::vector<std::string> act_types = {"StringAttribute"};
-    verify_ind_attribute("activation", act_types);
-
-    // Check whether StringAttribute 'Aggregation' is in Gene
-    std::vector<std::string> agg_types = {"StringAttribute"};
-    verify_ind_attribute("aggregation", agg_types);
-
-    for (std::map<std::string, Attribute_ptr>::iterator it = attributes.begin(); it != attributes.end(); it++)
-    {
-        (it->second)->validate();
-    }
+    mutate_member(genes, &NodeGene::bias, *config.bias_spec);
+    mutate_member(genes, &NodeGene::response, *config.response_spec);
+    mutate_member(genes, &NodeGene::time_constant, *config.time_constant_spec);
+    // these rates are usually small, only the genes that mutate are visited
+    for_each_bernoulli(genes.size(), config.activation_mutate_rate, [&genes, &config](size_t i)
+                       { genes[i].activation = random_option(config.activation_ids); });
+    for_each_bernoulli(genes.size(), config.aggregation_mutate_rate, [&genes, &config](size_t i)
+                       { genes[i].aggregation = random_option(config.aggregation_ids); });
+}
+/**
+ * @brief Generates a printable string for this Gene
+ *
+ * @return std::string
+ */
+std::string NodeGene::to_string() const
+{
+    return "NodeGene '" + std::to_string(key) + "'" +
+           "\n\tbias: " + std::to_string(bias) +
+           "\n\tresponse: " + std::to_string(response) +
+           "\n\tactivation: " + activation_name(activation) +
+           "\n\taggregation: " + aggregation_name(aggregation) +
+           "\n\ttime_constant: " + std::to_string(time_constant);
 }
 
 /// ------------ ConnectionGene Definitions ------------///
 
 // Constructors
 /**
- * @brief Construct a new Connection Gene:: Connection Gene object
+ * @brief Construct a new Connection Gene:: Connection Gene object with the given values
  *
  * @param _key
- * @param _attributes
+ * @param _weight
+ * @param _enabled
  */
-ConnectionGene::ConnectionGene(std::pair<int, int> _key, std::vector<Attribute_ptr> _attributes)
+ConnectionGene::ConnectionGene(std::pair<int, int> _key, float _weight, bool _enabled)
 {
     key = _key;
-    for (int i = 0; i < _attributes.size(); i++)
-    {
-        attributes[_attributes[i]->name] = _attributes[i];
-    }
-
-    verify_attributes();
+    weight = _weight;
+    enabled = _enabled;
+}
+/**
+ * @brief Construct a new Connection Gene:: Connection Gene object with values drawn from the config
+ *
+ * @param _key
+ * @param config
+ */
+ConnectionGene::ConnectionGene(std::pair<int, int> _key, const GenomeConfig &config)
+{
+    key = _key;
+    weight = config.weight_spec->init_float();
+    enabled = config.enabled_default;
 }
 
 // Other Functions
@@ -325,129 +220,88 @@ ConnectionGene::ConnectionGene(std::pair<int, int> _key, std::vector<Attribute_p
  * @param other
  * @return float
  */
-float ConnectionGene::distance(ConnectionGene_ptr &other, float compatability_weight)
+float ConnectionGene::distance(const ConnectionGene &other, float compatability_weight) const
 {
-    float weight = attributes["weight"]->get_float_value();
-    float other_weight = other->attributes["weight"]->get_float_value();
-
-    float dist = std::fabs(weight - other_weight);
-
-    if (attributes["enable"]->get_bool_value() xor other->attributes["enable"]->get_bool_value())
+    float dist = std::fabs(weight - other.weight);
+    if (enabled xor other.enabled)
     {
         dist += 1.0F;
     }
-
     return dist * compatability_weight;
 }
 /**
- * @brief Creates a pointer to a new copy of this ConnectionGene
+ * @brief Creates a new ConnectionGene inheriting each value from a random parent
  *
- * @return ConnectionGene*
+ * @return ConnectionGene
  */
-ConnectionGene_ptr ConnectionGene::copy()
+ConnectionGene ConnectionGene::crossover(const ConnectionGene &gene2) const
 {
-    std::vector<Attribute_ptr> attributes_copy;
-    attributes_copy.reserve(attributes.size());
-    for (std::map<std::string, Attribute_ptr>::iterator it = attributes.begin(); it != attributes.end(); it++)
-    {
-        Attribute_ptr new_attr = (it->second)->copy();
-        attributes_copy.push_back(new_attr);
-    }
-    return std::make_shared<ConnectionGene>(this->key, attributes_copy);
-}
-/**
- * @brief Creates an std::make_shared<ConnectionGene>  with a mix of attributes between each gene
- *
- * @return ConnectionGene*
- */
-ConnectionGene_ptr ConnectionGene::crossover(ConnectionGene_ptr &gene2)
-{
-    if ((this->key.first != gene2->key.first) && (this->key.second != gene2->key.second))
+    if (key != gene2.key)
     {
         throw std::invalid_argument("Invalid Crossover between ConnectionGeene: (" +
                                     std::to_string(this->key.first) + ", " +
                                     std::to_string(this->key.second) + ") and (" +
-                                    std::to_string(gene2->key.first) + ", " +
-                                    std::to_string(gene2->key.second) + ")");
+                                    std::to_string(gene2.key.first) + ", " +
+                                    std::to_string(gene2.key.second) + ")");
     }
 
-    std::vector<Attribute_ptr> attributes_copy;
-    attributes_copy.reserve(std::max(attributes_copy.size(), gene2->attributes.size()));
-    for (std::map<std::string, Attribute_ptr>::iterator it = attributes.begin(); it != attributes.end(); it++)
+    ConnectionGene child = *this;
+    if (rand_bool(0.5))
     {
-        Attribute_ptr new_attr;
-        // If the Attribute is shared between the genes then randomly pick one of the parents to inherit from
-        if (gene2->has_attribute(it->first))
-        {
-            if (rand_bool(0.5))
-            {
-                new_attr = gene2->attributes[it->first]->copy();
-            }
-            else
-            {
-                new_attr = (it->second)->copy();
-            }
-            attributes_copy.push_back(new_attr);
-        }
+        child.weight = gene2.weight;
+    }
+    if (rand_bool(0.5))
+    {
+        child.enabled = gene2.enabled;
     }
-    return std::make_shared<ConnectionGene>(this->key, attributes_copy);
+    return child;
 }
 /**
- * @brief Generates a printable string for this Gene
+ * @brief Mutates every value of this gene with the rates in config
  *
- * @return std::string
+ * @param config
  */
-std::string ConnectionGene::to_string()
+void ConnectionGene::mutate(const GenomeConfig &config)
 {
-    std::string ret_str = "ConnectionGene (" + std::to_string(key.first) + ", " + std::to_string(key.second) + ")";
-    for (std::map<std::string, Attribute_ptr>::iterator it = attributes.begin(); it != attributes.end(); it++)
-    {
-        ret_str = ret_str + "\n\t" + (it->second)->to_string();
-    }
-
-    return ret_str;
+    mutate_all(std::span<ConnectionGene>(this, 1), config);
 }
 /**
- * @brief Verifies all Attributes are valid
+ * @brief Mutates every gene like mutate, the weights of all genes at once
  *
+ * @param genes contiguous genes, e.g. a block of a GeneVector
+ * @param config
  */
-void ConnectionGene::verify_attributes()
+void ConnectionGene::mutate_all(std::span<ConnectionGene> genes, const GenomeConfig &config)
 {
-    // Check whether FloatAttribute/IntAttribute 'weight' is in Gene
-    std::vector<std::string> weight_types = {"FloatAttribute", "IntAttribute"};
-    verify_ind_attribute("weight", weight_types);
-
-    // Check whether BoolAttribute 'enables' is in Gene
-    verify_ind_attribute("enable", "BoolAttribute");
-
-    for (std::map<std::string, Attribute_ptr>::iterator it = attributes.begin(); it != attributes.end(); it++)
-    {
-        (it->second)->validate();
-    }
+    mutate_member(genes, &ConnectionGene::weight, *config.weight_spec);
+    // the rate is usually small, only the genes that mutate are visited
+    for_each_bernoulli(genes.size(), config.enabled_mutate_rate, [&genes](size_t i)
+                       { genes[i].enabled = rand_bool(0.5); });
+}
+/**
+ * @brief Generates a printable string for this Gene
+ *
+ * @return std::string
+ */
+std::string ConnectionGene::to_string() const
+{
+    return "ConnectionGene (" + std::to_string(key.first) + ", " + std::to_string(key.second) + ")" +
+           "\n\tweight: " + std::to_string(weight) +
+           "\n\tenabled: " + (enabled ? "true" : "false");
 }
 /**
- * @brief enables the 'enable' attribute of this Connection gene
+ * @brief enables this Connection gene
  *
  */
 void ConnectionGene::enable()
 {
-    // if not enabled, replace the enable attribute with a new one with the default value true
-    if (!get_attribute("enable")->get_bool_value())
-    {
-        float mr = this->get_attribute("enable")->get_mutate_rate();
-        this->attributes["enable"] = std::make_shared<BoolAttribute>("enable", true, mr);
-    }
+    enabled = true;
 }
 /**
- * @brief disables the 'enable' attribute of this Connection gene
+ * @brief disables this Connection gene
  *
  */
 void ConnectionGene::disable()
 {
-    // if enabled, replace the enable attribute with a new one with the default value false
-    if (get_attribute("enable")->get_bool_value())
-    {
-        float mr = this->get_attribute("enable")->get_mutate_rate();
-        this->attributes["enable"] = std::make_shared<BoolAttribute>("enable", true, mr);
-    }
-}
\ No newline at end of file
+    enabled = false;
+}
@@ -7,11 +7,29 @@
 #include <set>
 #include <queue>
 #include <unordered_map>
+#include <algorithm>
+#include <limits>
 #include <cassert>
 #include "genes.h"
 #include "aggregations.h"
 #include "activations.h"
+#include "network.h"
 #include "config_parser.h"
+#include "attributes.h"
+
+/**
+ * @brief checks a probability is in [0, 1]
+ *
+ * @param name
+ * @param rate
+ */
+static void validate_rate(const std::string &name, float rate)
+{
+    if (rate < 0 || rate > 1.0F)
+    {
+        throw std::invalid_argument(name + " (" + std::to_string(rate) + ") must be between 0 and 1");
+    }
+}
 
 GenomeConfig::GenomeConfig(ConfigParser_ptr _config)
 {
@@ -52,12 +70,34 @@ GenomeConfig::GenomeConfig(ConfigParser_ptr _config)
     response_mutate_rate = get_value<float>("response_mutate_rate");
     response_replace_rate = get_value<float>("response_replace_rate");
 
+    // optional, only CTRNNs use the time constant, a fixed time constant of 1 unless configured
+    time_constant_init_mean = has_value("time_constant_init_mean") ? get_value<float>("time_constant_init_mean") : 1.0F;
+    time_constant_init_stdev = has_value("time_constant_init_stdev") ? get_value<float>("time_constant_init_stdev") : 0.0F;
+    time_constant_init_type = has_value("time_constant_init_type") ? get_value<std::string>("time_constant_init_type") : "gaussian";
+    time_constant_max_value = has_value("time_constant_max_value") ? get_value<float>("time_constant_max_value") : 100.0F;
+    time_constant_min_value = has_value("time_constant_min_value") ? get_value<float>("time_constant_min_value") : 0.01F;
+    time_constant_mutate_power = has_value("time_constant_mutate_power") ? get_value<float>("time_constant_mutate_power") : 0.0F;
+    time_constant_mutate_rate = has_value("time_constant_mutate_rate") ? get_value<float>("time_constant_mutate_rate") : 0.0F;
+    time_constant_replace_rate = has_value("time_constant_replace_rate") ? get_value<float>("time_constant_replace_rate") : 0.0F;
+
     // Connection Parameters
+    // optional, genomes are feed forward unless recurrent connections are allowed
+    feed_forward = true;
+    if (has_value("feed_forward"))
+    {
+        feed_forward = get_value<bool>("feed_forward");
+    }
     initial_connection = get_value<std::string>("initial_connection");
 
     activation_default = get_value<std::string>("activation_default");
     activation_mutate_rate = get_value<float>("activation_mutate_rate");
     activation_options = get_value<std::set<std::string>>("activation_options");
+    // optional, exact unless approximate activations are requested
+    activation_precision = valid_precisions::exact;
+    if (has_value("activation_precision"))
+    {
+        activation_precision = to_precision(get_value<std::string>("activation_precision"));
+    }
 
     aggregation_default = get_value<std::string>("aggregation_default");
     aggregation_mutate_rate = get_value<float>("aggregation_mutate_rate");
@@ -76,9 +116,43 @@ GenomeConfig::GenomeConfig(ConfigParser_ptr _config)
     weight_mutate_power = get_value<float>("weight_mutate_power");
     weight_mutate_rate = get_value<float>("weight_mutate_rate");
     weight_replace_rate = get_value<float>("weight_replace_rate");
+
+    // genes store the id of their activation and aggregation, resolve the names once here
+    for (const std::string &option : activation_options)
+    {
+        activation_ids.push_back(to_activation(option));
+    }
+    for (const std::string &option : aggregation_options)
+    {
+        aggregation_ids.push_back(to_aggregation(option));
+    }
+    if (activation_ids.empty() || aggregation_ids.empty())
+    {
+        throw std::invalid_argument("At least 1 activation and aggregation option must be provided");
+    }
+
+    // The specs validate the parameters, genes use them without checking
+    bias_spec = std::make_shared<AttributeSpec>(float_attribute, "bias", bias_init_mean, bias_init_stdev, bias_init_type, bias_mutate_rate, bias_mutate_power, bias_min_value, bias_max_value);
+    response_spec = std::make_shared<AttributeSpec>(float_attribute, "response", response_init_mean, response_init_stdev, response_init_type, response_mutate_rate, response_mutate_power, response_min_value, response_max_value);
+    time_constant_spec = std::make_shared<AttributeSpec>(float_attribute, "time_constant", time_constant_init_mean, time_constant_init_stdev, time_constant_init_type, time_constant_mutate_rate, time_constant_mutate_power, time_constant_min_value, time_constant_max_value);
+    weight_spec = std::make_shared<AttributeSpec>(float_attribute, "weight", weight_init_mean, weight_init_stdev, weight_init_type, weight_mutate_rate, weight_mutate_power, weight_min_value, weight_max_value);
+    validate_rate("activation_mutate_rate", activation_mutate_rate);
+    validate_rate("aggregation_mutate_rate", aggregation_mutate_rate);
+    validate_rate("enabled_mutate_rate", enabled_mutate_rate);
+
+    // The initial genomes use the keys up to num_outputs + num_hidden
+    innovation_tracker = std::make_shared<InnovationTracker>(num_outputs + num_hidden);
 }
 
-Genome::Genome(int _key, ConfigParser_ptr _config)
+/**
+ * @brief Create a new genome with the initial nodes and connections described by the config
+ *
+ * @param _key genome key
+ * @param _config config shared by every genome of the population
+ * @param resource memory resource for the gene vectors
+ */
+Genome::Genome(int _key, GenomeConfig_ptr _config, std::pmr::memory_resource *resource)
+    : connections(resource), nodes(resource), input_edges(resource), node_order(resource), reachability_words(0), reachability_valid(false)
 {
     key = _key;
     fitness = 0.F;
@@ -86,15 +160,17 @@ Genome::Genome(int _key, ConfigParser_ptr _config)
     // Point to the container containing the configuration for all genomes
     // (So the memory of each genome doesnt have to maintain a copy of each parameter,
     //  instead they can merely access the information stored inside the GenomeConfig)
-    config = std::make_shared<GenomeConfig>(_config);
+    config = _config;
 
     // Create all input nodes
+    std::vector<NodeGene> node_list;
+    node_list.reserve(config->num_inputs + config->num_outputs + config->num_hidden);
     for (int in_node = 1; in_node <= config->num_inputs; in_node++)
     {
         // All input nodes have negative values starting at -1
         int node_key = -1 * in_node;
         // Create New Node
-        nodes[node_key] = new_node(node_key);
+        node_list.push_back(new_node(node_key));
         // Add key to list of output keys
         input_keys.insert(node_key);
     }
@@ -104,7 +180,7 @@ Genome::Genome(int _key, ConfigParser_ptr _config)
         // All output nodes have positive values starting at 0
         int node_key = out_node;
         // Create New Node
-        nodes[node_key] = new_node(node_key);
+        node_list.push_back(new_node(node_key));
         // Add key to list of output keys
         output_keys.insert(node_key);
     }
@@ -114,10 +190,21 @@ Genome::Genome(int _key, ConfigParser_ptr _config)
         // All hidden nodes have positive values starting at num_outputs
         int node_key = hid_node + config->num_outputs;
         // Create New Node
-        nodes[node_key] = new_node(node_key);
+        node_list.push_back(new_node(node_key));
         // Add key to list of hidden keys
         hidden_keys.insert(node_key);
     }
+    nodes.assign(node_list);
+    // initial connections only run from inputs to hidden nodes to outputs
+    next_order = 0;
+    for (std::set<int> *keys : {&input_keys, &hidden_keys, &output_keys})
+    {
+        for (int node_key : *keys)
+        {
+            node_order.push_back({node_key, next_order++});
+        }
+    }
+    std::sort(node_order.begin(), node_order.end());
     // Create connections between nodes
     std::vector<std::pair<int, int>> connection_list;
     if (config->initial_connection == "full_direct")
@@ -133,16 +220,37 @@ Genome::Genome(int _key, ConfigParser_ptr _config)
         throw(std::invalid_argument("Incorrect initial condition provided"));
     }
 
+    std::vector<ConnectionGene> connection_genes;
+    connection_genes.reserve(connection_list.size());
+    for (std::pair<int, int> conn_key : connection_list)
+    {
+        connection_genes.push_back(new_connection(conn_key));
+    }
+    connections.assign(connection_genes);
+    input_edges.reserve(connection_list.size());
     for (std::pair<int, int> conn_key : connection_list)
     {
-        connections[conn_key] = new_connection(conn_key);
+        input_edges.push_back({conn_key.second, conn_key.first});
     }
+    std::sort(input_edges.begin(), input_edges.end());
 
     // has this node been activated (raw nodes and connections turned into feed forward layers)
     activated = false;
+    indexed_versions = gene_versions();
+    activated_versions = indexed_versions;
 }
 
-Genome::Genome(int _key, Genome_ptr &g1, Genome_ptr &g2, ConfigParser_ptr _config)
+/**
+ * @brief Create a child genome by crossing over g1 and g2
+ *
+ * @param _key genome key
+ * @param g1 first parent
+ * @param g2 second parent
+ * @param _config config shared by every genome of the population
+ * @param resource memory resource for the gene vectors
+ */
+Genome::Genome(int _key, Genome_ptr &g1, Genome_ptr &g2, GenomeConfig_ptr _config, std::pmr::memory_resource *resource)
+    : connections(resource), nodes(resource), input_edges(resource), node_order(resource), reachability_words(0), reachability_valid(false)
 {
     key = _key;
     fitness = 0.F;
@@ -150,7 +258,15 @@ Genome::Genome(int _key, Genome_ptr &g1, Genome_ptr &g2, ConfigParser_ptr _confi
     // Point to the container containing the configuration for all genomes
     // (So the memory of each genome doesnt have to maintain a copy of each parameter,
     //  instead they can merely access the information stored inside the GenomeConfig)
-    config = std::make_shared<GenomeConfig>(_config);
+    config = _config;
+
+    // Node keys are only consistent between genomes that split connections through the same tracker
+    if (g1->config->innovation_tracker != config->innovation_tracker ||
+        g2->config->innovation_tracker != config->innovation_tracker)
+    {
+        throw std::invalid_argument("Crossover parents and child must share an innovation tracker, "
+                                    "create them from the same GenomeConfig");
+    }
 
     Genome_ptr parent1;
     Genome_ptr parent2;
@@ -165,21 +281,12 @@ Genome::Genome(int _key, Genome_ptr &g1, Genome_ptr &g2, ConfigParser_ptr _confi
         parent2 = g1;
     }
 
-    // Crossover all nodes from parents
-    for (std::pair<const int, NodeGene_ptr> &nit : parent1->nodes)
-    {
-        const int nid = nit.first;
-        NodeGene_ptr n1 = nit.second;
-        if (parent2->nodes.count(nid))
-        {
-            NodeGene_ptr n2 = parent2->nodes[nid];
-            nodes[nid] = n1->crossover(n2);
-        }
-        else
-        {
-            nodes[nid] = n1->copy();
-        }
-
+    // Crossover all nodes from parents, both gene vectors are sorted so walk them together.
+    // Blocks of genes the child inherits unchanged stay shared with parent1
+    GeneVector<NodeGene>::const_iterator n2 = parent2->nodes.begin();
+    nodes.assign_derived(parent1->nodes, [this, &parent2, &n2](const NodeGene &n1)
+                         {
+        const int nid = n1.key;
         // Insert keys into key sets
         if (nid < 0)
         {
@@ -193,26 +300,111 @@ Genome::Genome(int _key, Genome_ptr &g1, Genome_ptr &g2, ConfigParser_ptr _confi
         {
             hidden_keys.insert(nid);
         }
-    }
+
+        while (n2 != parent2->nodes.end() && n2->key < nid)
+        {
+            n2++;
+        }
+        if (n2 != parent2->nodes.end() && n2->key == nid)
+        {
+            return n1.crossover(*n2);
+        }
+        return n1; });
 
     // Crossover all Connections
-    for (const std::pair<std::pair<int, int>, ConnectionGene_ptr> &cit : parent1->connections)
-    {
-        const std::pair<int, int> cid = cit.first;
-        ConnectionGene_ptr c1 = cit.second;
-        if (parent2->connections.count(cid))
+    GeneVector<ConnectionGene>::const_iterator c2 = parent2->connections.begin();
+    connections.assign_derived(parent1->connections, [&parent2, &c2](const ConnectionGene &c1)
+                               {
+        const std::pair<int, int> cid = c1.key;
+        while (c2 != parent2->connections.end() && c2->key < cid)
         {
-            ConnectionGene_ptr c2 = parent2->connections[cid];
-            connections[cid] = c1->crossover(c2);
+            c2++;
         }
-        else
+        if (c2 != parent2->connections.end() && c2->key == cid)
         {
-            connections[cid] = c1->copy();
+            return c1.crossover(*c2);
         }
+        return c1; });
+    // the child has exactly the connections of parent1
+    input_edges.assign(parent1->input_edges.begin(), parent1->input_edges.end());
+    node_order.assign(parent1->node_order.begin(), parent1->node_order.end());
+    next_order = parent1->next_order;
+    if (parent1->reachability_valid)
+    {
+        reachability = parent1->reachability;
+        reachability_words = parent1->reachability_words;
+        reachability_valid = true;
     }
 
     activated = false;
+    indexed_versions = gene_versions();
+    activated_versions = indexed_versions;
 }
+/**
+ * @brief Create a standalone genome that parses its own config,
+ * genomes of a population share a single GenomeConfig instead.
+ * The genome gets an innovation tracker of its own, so it can only be crossed
+ * over with its own descendants
+ */
+Genome::Genome(int _key, ConfigParser_ptr _config, std::pmr::memory_resource *resource)
+    : Genome(_key, std::make_shared<GenomeConfig>(_config), resource)
+{
+}
+
+/**
+ * @brief parses the config of a crossover child, keeping the innovation tracker of its parent
+ *
+ * @param config
+ * @param parent_config
+ * @return GenomeConfig_ptr
+ */
+static GenomeConfig_ptr parse_child_config(ConfigParser_ptr config, const GenomeConfig_ptr &parent_config)
+{
+    std::shared_ptr<GenomeConfig> child_config = std::make_shared<GenomeConfig>(config);
+    child_config->innovation_tracker = parent_config->innovation_tracker;
+    return child_config;
+}
+
+/**
+ * @brief Create a child genome by crossing over g1 and g2 with a config of its own,
+ * the child keeps using the innovation tracker of its parents
+ */
+Genome::Genome(int _key, Genome_ptr &g1, Genome_ptr &g2, ConfigParser_ptr _config, std::pmr::memory_resource *resource)
+    : Genome(_key, g1, g2, parse_child_config(_config, g1->config), resource)
+{
+}
+
+/**
+ * @brief Copy other with its genes allocated from resource,
+ * used to move surviving genomes into the arena of the next generation
+ *
+ * @param other genome to copy
+ * @param resource memory resource for the gene vectors
+ */
+Genome::Genome(const Genome &other, std::pmr::memory_resource *resource)
+    : key(other.key),
+      fitness(other.fitness),
+      connections(other.connections, resource),
+      nodes(other.nodes, resource),
+      config(other.config),
+      input_keys(other.input_keys),
+      output_keys(other.output_keys),
+      hidden_keys(other.hidden_keys),
+      forward_levels(other.forward_levels),
+      input_edges(other.input_edges, resource),
+      node_order(other.node_order, resource),
+      next_order(other.next_order),
+      reachability(other.reachability),
+      reachability_words(other.reachability_words),
+      reachability_valid(other.reachability_valid),
+      network(other.network),
+      recurrent_network(other.recurrent_network),
+      activated(other.activated),
+      indexed_versions(other.indexed_versions),
+      activated_versions(other.activated_versions)
+{
+}
+
 // Get sizes from key vectors as size can change after initialization from config
 /**
  * @brief return number of input nodes
@@ -263,71 +455,21 @@ int Genome::get_num_nodes()
  * @brief Generate a new node from the config with the provided node_key
  *
  * @param node_key
- * @return NodeGene*
- */
-NodeGene_ptr Genome::new_node(int node_key)
-{
-    // std::string bias_key = "gene" + std::to_string(key) + "_node" + std::to_string(node_key) + "_bias";
-    std::string bias_key = "bias";
-    FloatAttribute_ptr bias = std::make_shared<FloatAttribute>(bias_key,
-                                                               config->bias_init_mean,
-                                                               config->bias_init_stdev,
-                                                               config->bias_init_type,
-                                                               config->bias_mutate_rate,
-                                                               config->bias_mutate_power,
-                                                               config->bias_min_value,
-                                                               config->bias_max_value);
-    // Create Key that can identify where this attribute is in the network
-    // std::string response_key = "gene" + std::to_string(key) + "_node" + std::to_string(node_key) + "_response";
-    std::string response_key = "response";
-    FloatAttribute_ptr response = std::make_shared<FloatAttribute>(response_key,
-                                                                   config->response_init_mean,
-                                                                   config->response_init_stdev,
-                                                                   config->response_init_type,
-                                                                   config->response_mutate_rate,
-                                                                   config->response_mutate_power,
-                                                                   config->response_min_value,
-                                                                   config->response_max_value);
-    std::string activation_key = "activation";
-    StringAttribute_ptr activation = std::make_shared<StringAttribute>(activation_key,
-                                                                       config->activation_mutate_rate,
-                                                                       config->activation_options);
-    std::string aggregation_key = "aggregation";
-    StringAttribute_ptr aggregation = std::make_shared<StringAttribute>(aggregation_key,
-                                                                        config->aggregation_mutate_rate,
-                                                                        config->aggregation_options);
-    std::vector<Attribute_ptr> node_attributes = {bias, response, activation, aggregation};
-
-    NodeGene_ptr node = std::make_shared<NodeGene>(node_key, node_attributes);
-    return node;
+ * @return NodeGene
+ */
+NodeGene Genome::new_node(int node_key)
+{
+    return NodeGene(node_key, *config);
 }
 /**
  * @brief generates a new connection from the provided key
  *
  * @param connection_key
- * @return std::shared_pointer<>
+ * @return ConnectionGene
  */
-ConnectionGene_ptr Genome::new_connection(std::pair<int, int> connection_key)
+ConnectionGene Genome::new_connection(std::pair<int, int> connection_key)
 {
-    std::string weight_key = "weight";
-    FloatAttribute_ptr weight = std::make_shared<FloatAttribute>(weight_key,
-                                                                 config->weight_init_mean,
-                                                                 config->weight_init_stdev,
-                                                                 config->weight_init_type,
-                                                                 config->weight_mutate_rate,
-                                                                 config->weight_mutate_power,
-                                                                 config->weight_min_value,
-                                                                 config->weight_max_value);
-
-    std::string enable_key = "enable";
-    BoolAttribute_ptr enable = std::make_shared<BoolAttribute>(enable_key,
-                                                               config->enabled_default,
-                                                               config->enabled_mutate_rate);
-
-    std::vector<Attribute_ptr> connection_attributes = {weight, enable};
-
-    ConnectionGene_ptr conneciton = std::make_shared<ConnectionGene>(connection_key, connection_attributes);
-    return conneciton;
+    return ConnectionGene(connection_key, *config);
 }
 
 /**
@@ -421,31 +563,205 @@ void Genome::generate_full_connections(bool direct, std::vector<std::pair<int, i
     }
 }
 /**
- * @brief finds the inputs to each node in the network
- * Computes in linear time O(N) (O(num_nodes) + O(num_connections))
+ * @brief gets the (out, in) keys of every connection into node_key, enabled or not
+ * Computes in O(log(num_connections))
  *
- * @return std::map<int, std::vector<int>*>
+ * @param node_key
+ * @return std::span<const std::pair<int, int>>
  */
-void Genome::generate_node_inputs()
+std::span<const std::pair<int, int>> Genome::get_input_edges(int node_key) const
 {
-    node_inputs_map.clear();
-    // add all node keys to input map
-    for (std::map<int, NodeGene_ptr>::iterator node_it = nodes.begin(); node_it != nodes.end(); node_it++)
+    std::pmr::vector<std::pair<int, int>>::const_iterator first =
+        std::lower_bound(input_edges.begin(), input_edges.end(), std::pair<int, int>(node_key, std::numeric_limits<int>::min()));
+    std::pmr::vector<std::pair<int, int>>::const_iterator last =
+        std::upper_bound(first, input_edges.end(), std::pair<int, int>(node_key, std::numeric_limits<int>::max()));
+    return std::span<const std::pair<int, int>>(first, last);
+}
+/**
+ * @brief gets the first connection out of node_key, the connections out of the node
+ * follow it until the input of the key changes
+ * Computes in O(log(num_connections))
+ *
+ * @param node_key
+ * @return GeneVector<ConnectionGene>::const_iterator
+ */
+GeneVector<ConnectionGene>::const_iterator Genome::get_output_edges(int node_key) const
+{
+    return connections.lower_bound({node_key, std::numeric_limits<int>::min()});
+}
+/**
+ * @brief picks a connection uniformly at random in O(1) through the input index
+ *
+ * @return std::pair<int, int> key of the connection
+ */
+std::pair<int, int> Genome::random_connection() const
+{
+    const std::pair<int, int> &edge = input_edges[rand() % input_edges.size()];
+    return {edge.second, edge.first};
+}
+/**
+ * @brief adds a new connection gene, replacing an existing one with the same key,
+ * and indexes it as an input of its output node
+ *
+ * @param conn_key
+ */
+void Genome::add_connection(std::pair<int, int> conn_key)
+{
+    connections.insert(new_connection(conn_key));
+    std::pair<int, int> edge = {conn_key.second, conn_key.first};
+    std::pmr::vector<std::pair<int, int>>::iterator it = std::lower_bound(input_edges.begin(), input_edges.end(), edge);
+    if (it == input_edges.end() || *it != edge)
+    {
+        input_edges.insert(it, edge);
+    }
+    // recurrent genomes may contain cycles, only feed forward genomes keep an order
+    if (config->feed_forward)
     {
-        node_inputs_map.insert(std::pair<int, std::set<int>>(node_it->first, std::set<int>()));
+        update_order(conn_key);
+    }
+    if (reachability_valid)
+    {
+        // every node reaching the start (and the start itself) now reaches the end and everything after it
+        const size_t from = get_slot(conn_key.first);
+        const size_t to = get_slot(conn_key.second);
+        const uint64_t *to_row = &reachability[to * reachability_words];
+        for (size_t slot = 0; slot < node_order.size(); slot++)
+        {
+            uint64_t *row = &reachability[slot * reachability_words];
+            if (slot == from || (row[from / 64] >> (from % 64) & 1))
+            {
+                for (size_t word = 0; word < reachability_words; word++)
+                {
+                    row[word] |= to_row[word];
+                }
+                row[to / 64] |= uint64_t(1) << (to % 64);
+            }
+        }
+    }
+}
+/**
+ * @brief adds a new hidden node, placed last in the topological order
+ *
+ * @param node_key
+ */
+void Genome::add_hidden_node(int node_key)
+{
+    nodes.insert(new_node(node_key));
+    hidden_keys.insert(node_key);
+    std::pair<int, int> node = {node_key, next_order++};
+    node_order.insert(std::lower_bound(node_order.begin(), node_order.end(), node), node);
+    // the new node shifts the slots of every node after it
+    reachability_valid = false;
+}
+/**
+ * @brief removes a connection gene and its input index entry
+ *
+ * @param conn_key
+ */
+void Genome::delete_connection(std::pair<int, int> conn_key)
+{
+    connections.erase(conn_key);
+    // removing a connection can disconnect any pair of nodes
+    reachability_valid = false;
+    std::pair<int, int> edge = {conn_key.second, conn_key.first};
+    std::pmr::vector<std::pair<int, int>>::iterator it = std::lower_bound(input_edges.begin(), input_edges.end(), edge);
+    if (it != input_edges.end() && *it == edge)
+    {
+        input_edges.erase(it);
+    }
+}
+/**
+ * @brief versions of the node and connection genes, see GeneVector::version
+ *
+ * @return std::pair<uint64_t, uint64_t>
+ */
+std::pair<uint64_t, uint64_t> Genome::gene_versions() const
+{
+    return {nodes.version(), connections.version()};
+}
+/**
+ * @brief derives the key sets, input_edges and a topological node_order from the genes again
+ * The mutations keep these up to date, this is only needed after nodes or connections
+ * were modified directly. Nodes on a cycle are ordered after every other node
+ */
+void Genome::rebuild_index()
+{
+    input_keys.clear();
+    output_keys.clear();
+    hidden_keys.clear();
+    std::unordered_map<int, int> in_degree;
+    for (const NodeGene &node : nodes)
+    {
+        if (node.key < 0)
+        {
+            input_keys.insert(node.key);
+        }
+        else if (node.key < config->num_outputs)
+        {
+            output_keys.insert(node.key);
+        }
+        else
+        {
+            hidden_keys.insert(node.key);
+        }
+        in_degree[node.key] = 0;
     }
 
-    // iterate through all connections and add the input to the list of the output's inputs
-    for (std::map<std::pair<int, int>, ConnectionGene_ptr>::iterator conn_it = connections.begin(); conn_it != connections.end(); conn_it++)
+    input_edges.clear();
+    input_edges.reserve(connections.size());
+    for (const ConnectionGene &conn : connections)
     {
-        // if Connection is enabled then add the input to the list of output's inputs
-        if (conn_it->second->get_attribute("enable")->get_bool_value())
+        input_edges.push_back({conn.key.second, conn.key.first});
+        if (conn.key.first != conn.key.second && in_degree.count(conn.key.first) && in_degree.count(conn.key.second))
         {
-            int out = conn_it->first.second; // key
-            int in = conn_it->first.first;   // value
-            node_inputs_map[out].insert(in);
+            in_degree[conn.key.second]++;
         }
     }
+    std::sort(input_edges.begin(), input_edges.end());
+
+    // Kahn's algorithm, connections are sorted by their input so the outputs of a node are one range
+    std::vector<int> ordered;
+    ordered.reserve(nodes.size());
+    std::vector<int> ready;
+    for (const NodeGene &node : nodes)
+    {
+        if (in_degree[node.key] == 0)
+        {
+            ready.push_back(node.key);
+        }
+    }
+    while (!ready.empty())
+    {
+        const int node_key = ready.back();
+        ready.pop_back();
+        ordered.push_back(node_key);
+        for (GeneVector<ConnectionGene>::const_iterator it = get_output_edges(node_key);
+             it != connections.end() && it->key.first == node_key; it++)
+        {
+            std::unordered_map<int, int>::iterator target = in_degree.find(it->key.second);
+            if (it->key.second != node_key && target != in_degree.end() && --target->second == 0)
+            {
+                ready.push_back(it->key.second);
+            }
+        }
+    }
+    for (const NodeGene &node : nodes)
+    {
+        if (in_degree[node.key] > 0)
+        {
+            ordered.push_back(node.key);
+        }
+    }
+
+    node_order.clear();
+    for (int order = 0; order < static_cast<int>(ordered.size()); order++)
+    {
+        node_order.push_back({ordered[order], order});
+    }
+    std::sort(node_order.begin(), node_order.end());
+    next_order = static_cast<int>(ordered.size());
+    reachability_valid = false;
+    indexed_versions = gene_versions();
 }
 /**
  * @brief mutates the genome according to the configuration
@@ -454,7 +770,13 @@ void Genome::mutate()
 {
     // maybe remove the activated assertion and just activate network every mutation
     activated = false;
-    forward_order.clear();
+    forward_levels.clear();
+    network = nullptr;
+    recurrent_network = nullptr;
+    if (gene_versions() != indexed_versions)
+    {
+        rebuild_index();
+    }
     if (rand() * RAND_MAX_INV < config->node_add_prob)
     {
         mutate_add_node();
@@ -472,17 +794,14 @@ void Genome::mutate()
         mutate_delete_conn();
     }
 
-    for (std::pair<const int, NodeGene_ptr> &nit : nodes)
-    {
-        NodeGene_ptr n = nit.second;
-        n->mutate();
-    }
+    // Genes are mutated a block at a time, only blocks with a mutated gene stop being shared with the parents
+    nodes.update_blocks([this](std::span<NodeGene> genes)
+                        { NodeGene::mutate_all(genes, *config); });
 
-    for (std::pair<const std::pair<int, int>, ConnectionGene_ptr> &cit : connections)
-    {
-        ConnectionGene_ptr c = cit.second;
-        c->mutate();
-    }
+    connections.update_blocks([this](std::span<ConnectionGene> genes)
+                              { ConnectionGene::mutate_all(genes, *config); });
+    // the mutations kept the index up to date
+    indexed_versions = gene_versions();
 }
 /**
  * @brief adds random node
@@ -490,31 +809,33 @@ void Genome::mutate()
  */
 void Genome::mutate_add_node()
 {
-    // You will always be adding a hidden node
-    // Hidden nodes are always positive and begin their indexing at num_outputs
-    int new_node_key = get_num_outputs() + get_num_hidden();
-    NodeGene_ptr new_node_ptr = new_node(new_node_key);
-    nodes[new_node_key] = new_node_ptr;
-    hidden_keys.insert(new_node_key);
+    // Without connections there is nothing to split, add an unconnected node
+    if (connections.empty())
+    {
+        add_hidden_node(config->innovation_tracker->new_node_key());
+        return;
+    }
 
     // Choose random connection
-    if (connections.size())
+    std::pair<int, int> conn = random_connection();
+    int in = conn.first;
+    int out = conn.second;
+
+    // Genomes splitting the same connection this generation get the same node
+    // Hidden nodes are always positive and never reuse the key of a deleted node
+    int new_node_key = config->innovation_tracker->split_node_key(conn);
+    while (nodes.count(new_node_key))
     {
-        auto conn_it = connections.cbegin();
-        std::advance(conn_it, int(rand() % connections.size()));
-        std::pair<int, int> conn = conn_it->first;
-        int in = conn.first;
-        int out = conn.second;
-        // Now Disable the connection we are splitting
-        connections[conn]->disable();
-        // Generate the new connections into and out of the new node
-        std::pair<int, int> in_key = {in, new_node_key};
-        ConnectionGene_ptr in_conn = new_connection(in_key);
-        connections[in_key] = in_conn;
-        std::pair<int, int> out_key = {new_node_key, out};
-        ConnectionGene_ptr out_conn = new_connection(out_key);
-        connections[out_key] = out_conn;
+        new_node_key = config->innovation_tracker->new_node_key();
     }
+    add_hidden_node(new_node_key);
+
+    // Now Disable the connection we are splitting
+    connections.update(conn, [](ConnectionGene &c)
+                       { c.disable(); });
+    // Generate the new connections into and out of the new node
+    add_connection({in, new_node_key});
+    add_connection({new_node_key, out});
 }
 /**
  * @brief deletes random node
@@ -527,95 +848,118 @@ void Genome::mutate_delete_node()
     {
         return;
     }
-    // otherwise pick a random hidden node
-    auto node_key = hidden_keys.cbegin();
-    std::advance(node_key, rand() % get_num_hidden());
-    int node_to_remove = *node_key;
+    // otherwise pick a random hidden node, they have the largest keys so they end node_order
+    const size_t first_hidden = node_order.size() - get_num_hidden();
+    int node_to_remove = node_order[first_hidden + rand() % get_num_hidden()].first;
 
     // remove the node from the node map
     nodes.erase(node_to_remove); // delete the key and pointer from map
     hidden_keys.erase(node_to_remove);
-    node_inputs_map.erase(node_to_remove);
+    node_order.erase(std::lower_bound(node_order.begin(), node_order.end(), std::pair<int, int>(node_to_remove, std::numeric_limits<int>::min())));
+    reachability_valid = false;
 
-    // remove all connections to the node from the connection key
-    std::vector<std::pair<int, int>> conns_to_remove = {}; // store all the keys before erasing them from the map
-    conns_to_remove.reserve(nodes.size());                 // a node can at most be connected to every other node
-    for (std::pair<const std::pair<int, int>, ConnectionGene_ptr> &it : connections)
+    // remove all connections into and out of the node, found through the index in O(degree)
+    std::vector<std::pair<int, int>> removed_connections;
+    for (const std::pair<int, int> &edge : get_input_edges(node_to_remove))
+    {
+        removed_connections.push_back({edge.second, edge.first});
+    }
+    for (GeneVector<ConnectionGene>::const_iterator it = get_output_edges(node_to_remove);
+         it != connections.end() && it->key.first == node_to_remove; it++)
     {
-        std::pair<int, int> key = it.first;
-        ConnectionGene_ptr conn = it.second;
-        // if this node goes into or out of the node to remove then delete it
-        if (key.first == node_to_remove || key.second == node_to_remove)
+        // a recurrent self connection is already removed as an input
+        if (it->key.second != node_to_remove)
         {
-            if (key.first == node_to_remove)
-            {
-                node_inputs_map[key.second].erase(key.first);
-            }
-            else
-            {
-                node_inputs_map[key.first].erase(key.second);
-            }
-            conns_to_remove.push_back(key); // add this connection to the list of connections to remove from the map
+            removed_connections.push_back(it->key);
         }
     }
-    // remove all the needed conneciotns from the map
-    for (std::pair<int, int> c : conns_to_remove)
+    for (std::pair<int, int> conn_key : removed_connections)
     {
-        connections.erase(c);
+        delete_connection(conn_key);
     }
 }
 /**
- * @brief adds new connection
+ * @brief adds a random new connection, every possible connection is equally likely
+ * Random pairs are drawn and rejected until one is valid, only genomes where
+ * nearly every pair is taken enumerate all the possible connections
  *
  */
 void Genome::mutate_add_conn()
 {
-    std::set<int> possible_inputs;
-    std::set_union(input_keys.begin(), input_keys.end(), hidden_keys.begin(), hidden_keys.end(), std::inserter(possible_inputs, possible_inputs.begin()));
+    // node_order is sorted by key: the inputs (negative keys), then the outputs, then the hidden nodes
+    const size_t num_inputs = get_num_inputs();
+    const size_t num_outputs = get_num_outputs();
+    const size_t num_nodes = node_order.size();
+    // inputs and hidden nodes start connections, recurrent genomes may also feed outputs back into the network
+    const size_t num_sources = config->feed_forward ? num_nodes - num_outputs : num_nodes;
+    // hidden nodes and outputs end them
+    const size_t num_targets = num_nodes - num_inputs;
+    if (!num_sources || !num_targets)
+    {
+        return;
+    }
+    // position in node_order of the source with the given index, feed forward genomes skip the outputs
+    const bool skip_outputs = config->feed_forward;
+    auto source_key = [this, num_inputs, num_outputs, skip_outputs](size_t source)
+    {
+        return node_order[skip_outputs && source >= num_inputs ? source + num_outputs : source].first;
+    };
 
-    std::set<int> possible_outputs;
-    std::set_union(hidden_keys.begin(), hidden_keys.end(), output_keys.begin(), output_keys.end(), std::inserter(possible_outputs, possible_outputs.begin()));
+    // Rejecting invalid pairs keeps the remaining ones uniform
+    for (int attempt = 0; attempt < add_conn_attempts; attempt++)
+    {
+        std::pair<int, int> conn_key = {source_key(rand() % num_sources),
+                                        node_order[num_inputs + rand() % num_targets].first};
+        if (is_possible_connection(conn_key))
+        {
+            add_connection(conn_key);
+            return;
+        }
+    }
 
-    // Generate all permutations of inputs and outputs
-    // Notes:
-    // - Node cant connect to itself
-    // - Node can not connect a loop
-    std::set<std::pair<int, int>> possible_connections;
-    for (int i : possible_inputs)
+    // Every draw was rejected, collect all the possible connections instead
+    std::vector<std::pair<int, int>> possible_connections;
+    for (size_t source = 0; source < num_sources; source++)
     {
-        for (int o : possible_outputs)
+        for (size_t target = num_inputs; target < num_nodes; target++)
         {
-            // Construct the possible connection key
-            std::pair<int, int> conn_key = {i, o};
-            // Pass if attempting to make a connection to itself
-            if (i == o)
+            std::pair<int, int> conn_key = {source_key(source), node_order[target].first};
+            if (is_possible_connection(conn_key))
             {
-                continue;
+                possible_connections.push_back(conn_key);
             }
-            // Pass if this connection already exists
-            if (connections.find(conn_key) != connections.end())
-            {
-                continue;
-            }
-            // Pass if this connections completes the a cycle
-            if (creates_cycle(conn_key))
-            {
-                continue;
-            }
-            // If you reached this point, its safe to add it to a possible conneciton
-            possible_connections.insert(conn_key);
         }
     }
     // Don't continue if there are no possible connections to add
-    if (!possible_connections.size())
+    if (possible_connections.empty())
     {
         return;
     }
     // Pick a random connection from the possible connections and add it to the network
-    auto it = possible_connections.begin();
-    std::advance(it, rand() % possible_connections.size());
-    std::pair<int, int> conn_key = *it;
-    connections[conn_key] = new_connection(conn_key);
+    add_connection(possible_connections[rand() % possible_connections.size()]);
+}
+/**
+ * @brief checks whether conn_key can be added as a new connection
+ * Notes:
+ * - Node cant connect to itself (only recurrent genomes may)
+ * - Node can not connect a loop (only recurrent genomes may)
+ *
+ * @param conn_key
+ * @return true
+ * @return false
+ */
+bool Genome::is_possible_connection(std::pair<int, int> conn_key)
+{
+    if (conn_key.first == conn_key.second && config->feed_forward)
+    {
+        return false;
+    }
+    // Pass if this connection already exists
+    if (connections.count(conn_key))
+    {
+        return false;
+    }
+    return !config->feed_forward || !creates_cycle(conn_key);
 }
 /**
  * @brief deletes random connection
@@ -628,13 +972,12 @@ void Genome::mutate_delete_conn()
     {
         return;
     }
-    auto it = connections.begin();
-    std::advance(it, rand() % connections.size());
-    connections.erase(it->first);
+    delete_connection(random_connection());
 }
 
 /**
  * @brief checks whether the given connection creates a cycle in the nodes
+ * Only visits the nodes reachable from the end of the connection
  *
  * @param conn
  * @return true
@@ -642,183 +985,565 @@ void Genome::mutate_delete_conn()
  */
 bool Genome::creates_cycle(std::pair<int, int> conn)
 {
-    // Create a map of node keys and the nodes they connect to
-    std::unordered_map<int, std::vector<int>> conn_map;
-    for (auto it : connections)
+    // the connection closes a cycle if its end already reaches its start
+    return conn.first == conn.second || reaches(conn.second, conn.first);
+}
+/**
+ * @brief checks whether there is a path of enabled or disabled connections from from_key to to_key
+ * A single bit test while the genome is small enough for the reachability matrix, otherwise
+ * a search limited to the nodes between the two in the topological order.
+ * Only feed forward genomes keep the structures this relies on
+ *
+ * @param from_key
+ * @param to_key
+ * @return true
+ * @return false
+ */
+bool Genome::reaches(int from_key, int to_key)
+{
+    if (!config->feed_forward)
     {
-        std::pair<int, int> key = it.first;
-        // If input is not in map create list
-        if (conn_map.find(key.first) == conn_map.end())
+        throw std::runtime_error("Only feed forward genomes track reachability");
+    }
+    if (use_reachability())
+    {
+        size_t bit = get_slot(to_key);
+        return reachability[get_slot(from_key) * reachability_words + bit / 64] >> (bit % 64) & 1;
+    }
+
+    // the order puts every node before the nodes it reaches
+    const int upper = get_order(to_key);
+    if (get_order(from_key) >= upper)
+    {
+        return false;
+    }
+    // DFS through the outputs of from_key, only nodes ordered before to_key can lead to it
+    std::set<int> visited = {from_key};
+    std::vector<int> stack = {from_key};
+    while (!stack.empty())
+    {
+        int curr = stack.back();
+        stack.pop_back();
+        for (GeneVector<ConnectionGene>::const_iterator it = get_output_edges(curr);
+             it != connections.end() && it->key.first == curr; it++)
         {
-            std::vector<int> outs = {key.second};
-            conn_map[key.first] = outs;
+            int o = it->key.second;
+            if (o == to_key)
+            {
+                return true;
+            }
+            if (get_order(o) < upper && visited.insert(o).second)
+            {
+                stack.push_back(o);
+            }
         }
-        else
+    }
+    return false;
+}
+/**
+ * @brief checks whether node_key is an output or reaches one, nodes that don't can never
+ * change the outputs of the network. Genomes too large for the reachability matrix
+ * treat every node as reaching an output
+ *
+ * @param node_key
+ * @return true
+ * @return false
+ */
+bool Genome::reaches_output(int node_key)
+{
+    if (output_keys.count(node_key))
+    {
+        return true;
+    }
+    if (!use_reachability())
+    {
+        return true;
+    }
+    const uint64_t *row = &reachability[get_slot(node_key) * reachability_words];
+    for (int out_key : output_keys)
+    {
+        size_t bit = get_slot(out_key);
+        if (row[bit / 64] >> (bit % 64) & 1)
         {
-            conn_map[key.first].push_back(key.second);
+            return true;
         }
     }
+    return false;
+}
+/**
+ * @brief gets the slot of node_key, its index in node_order
+ *
+ * @param node_key
+ * @return size_t
+ */
+size_t Genome::get_slot(int node_key) const
+{
+    return std::lower_bound(node_order.begin(), node_order.end(), node_key, [](const std::pair<int, int> &node, int key)
+                            { return node.first < key; }) -
+           node_order.begin();
+}
+/**
+ * @brief checks whether reachability is answered by the matrix, building it if it is out of date
+ *
+ * @return true
+ * @return false
+ */
+bool Genome::use_reachability()
+{
+    if (!config->feed_forward || node_order.size() > max_reachability_nodes)
+    {
+        return false;
+    }
+    if (!reachability_valid)
+    {
+        build_reachability();
+    }
+    return true;
+}
+/**
+ * @brief builds the reachability matrix from scratch
+ * Computes in O(num_nodes * (num_nodes + num_connections) / 64)
+ */
+void Genome::build_reachability()
+{
+    const size_t num_nodes = node_order.size();
+    reachability_words = (num_nodes + 63) / 64;
+    reachability.assign(num_nodes * reachability_words, 0);
 
-    std::set<int> visited;
-    std::queue<int> q;
-    q.push(conn.second);
-    int curr;
-    // BFS, if you get to the beginning of the test connection then
-    while (!q.empty())
+    // visit the nodes in reverse topological order, so the rows of all outputs of a node are complete
+    std::vector<std::pair<int, size_t>> ordered_slots;
+    ordered_slots.reserve(num_nodes);
+    for (size_t slot = 0; slot < num_nodes; slot++)
     {
-        curr = q.front();
-        q.pop();
-        visited.insert(curr);
-        for (int o : conn_map[curr])
+        ordered_slots.push_back({node_order[slot].second, slot});
+    }
+    std::sort(ordered_slots.rbegin(), ordered_slots.rend());
+    for (const std::pair<int, size_t> &ordered_slot : ordered_slots)
+    {
+        const int node_key = node_order[ordered_slot.second].first;
+        uint64_t *row = &reachability[ordered_slot.second * reachability_words];
+        for (GeneVector<ConnectionGene>::const_iterator it = get_output_edges(node_key);
+             it != connections.end() && it->key.first == node_key; it++)
         {
-            // if the potential node is the beginning of the cycle then return true
+            size_t out_slot = get_slot(it->key.second);
+            const uint64_t *out_row = &reachability[out_slot * reachability_words];
+            for (size_t word = 0; word < reachability_words; word++)
+            {
+                row[word] |= out_row[word];
+            }
+            row[out_slot / 64] |= uint64_t(1) << (out_slot % 64);
+        }
+    }
+    reachability_valid = true;
+}
+/**
+ * @brief gets the position of node_key in the topological order
+ *
+ * @param node_key
+ * @return int
+ */
+int Genome::get_order(int node_key) const
+{
+    return std::lower_bound(node_order.begin(), node_order.end(), node_key, [](const std::pair<int, int> &node, int key)
+                            { return node.first < key; })
+        ->second;
+}
+/**
+ * @brief changes the position of node_key in the topological order
+ *
+ * @param node_key
+ * @param order
+ */
+void Genome::set_order(int node_key, int order)
+{
+    std::lower_bound(node_order.begin(), node_order.end(), node_key, [](const std::pair<int, int> &node, int key)
+                     { return node.first < key; })
+        ->second = order;
+}
+/**
+ * @brief restores the topological order after conn was added (Pearce-Kelly)
+ * Only the nodes ordered between the end and the start of conn that are connected
+ * to either of them move, they swap positions among themselves
+ *
+ * @param conn connection that must not create a cycle
+ */
+void Genome::update_order(std::pair<int, int> conn)
+{
+    const int lower = get_order(conn.second);
+    const int upper = get_order(conn.first);
+    if (lower > upper)
+    {
+        return;
+    }
+
+    // nodes reachable from the end of the connection that are ordered before its start
+    std::vector<std::pair<int, int>> forward = {{lower, conn.second}};
+    std::set<int> visited = {conn.second};
+    std::vector<int> stack = {conn.second};
+    while (!stack.empty())
+    {
+        int curr = stack.back();
+        stack.pop_back();
+        for (GeneVector<ConnectionGene>::const_iterator it = get_output_edges(curr);
+             it != connections.end() && it->key.first == curr; it++)
+        {
+            int o = it->key.second;
             if (o == conn.first)
             {
-                return true;
+                throw std::runtime_error("Connection creates a cycle in a feed forward genome");
             }
-            if (visited.find(o) == visited.end())
+            int order = get_order(o);
+            if (order < upper && visited.insert(o).second)
             {
-                q.push(o);
+                forward.push_back({order, o});
+                stack.push_back(o);
             }
         }
     }
-    // If you BFS'd through all the points and didnt create a loop then return false
-    return false;
+
+    // nodes reaching the start of the connection that are ordered after its end
+    std::vector<std::pair<int, int>> backward = {{upper, conn.first}};
+    visited = {conn.first};
+    stack = {conn.first};
+    while (!stack.empty())
+    {
+        int curr = stack.back();
+        stack.pop_back();
+        for (const std::pair<int, int> &edge : get_input_edges(curr))
+        {
+            int order = get_order(edge.second);
+            if (order > lower && visited.insert(edge.second).second)
+            {
+                backward.push_back({order, edge.second});
+                stack.push_back(edge.second);
+            }
+        }
+    }
+
+    // both sets keep their relative order, the backward nodes take the lowest positions of the two
+    std::sort(forward.begin(), forward.end());
+    std::sort(backward.begin(), backward.end());
+    std::vector<int> orders;
+    orders.reserve(forward.size() + backward.size());
+    for (const std::pair<int, int> &node : backward)
+    {
+        orders.push_back(node.first);
+    }
+    for (const std::pair<int, int> &node : forward)
+    {
+        orders.push_back(node.first);
+    }
+    std::sort(orders.begin(), orders.end());
+    std::vector<int>::iterator order = orders.begin();
+    for (const std::pair<int, int> &node : backward)
+    {
+        set_order(node.second, *order++);
+    }
+    for (const std::pair<int, int> &node : forward)
+    {
+        set_order(node.second, *order++);
+    }
 }
 /**
  * @brief activates this network to be efficiently computed in the forward function
+ * Splits the nodes into topological levels, every node in a level only depends on
+ * nodes of earlier levels. The topological order is kept up to date by the mutations,
+ * so this is a single pass O(num_nodes log(num_nodes) + num_connections)
+ * Recurrent genomes (feed_forward = False) compile a RecurrentNetwork instead
+ * If the genes haven't changed since the last activation the network is kept and only
+ * its state is reset, so every activation starts from the same state
  */
 void Genome::activate()
 {
-    std::set<int> added_keys;
-    // empty the cached forward order
-    forward_order.clear();
-    // recalculate the inputs to each node
-    generate_node_inputs();
-    // inputs dont have any dependent nodes so add them first
+    // nothing changed since the last activation (e.g. an elite carried over unchanged)
+    if (activated && gene_versions() == activated_versions)
+    {
+        reset();
+        return;
+    }
+    activated = false;
+    // the genes were modified directly, derive the index from them again
+    if (gene_versions() != indexed_versions)
+    {
+        rebuild_index();
+    }
+    activated_versions = gene_versions();
+    // empty the cached levels
+    forward_levels.clear();
+    if (!config->feed_forward)
+    {
+        // recurrent genomes have no order, every node is updated at once each step
+        compile_recurrent_network();
+        activated = true;
+        return;
+    }
+
+    // walk the nodes in their maintained topological order, so every input of a node has its level already
+    std::vector<std::pair<int, int>> ordered_nodes;
+    ordered_nodes.reserve(node_order.size());
+    for (const std::pair<int, int> &node : node_order)
+    {
+        ordered_nodes.push_back({node.second, node.first});
+    }
+    std::sort(ordered_nodes.begin(), ordered_nodes.end());
+
+    // inputs dont have any dependent nodes so they form the first level
+    forward_levels.push_back(std::vector<int>(input_keys.begin(), input_keys.end()));
+    std::unordered_map<int, size_t> node_levels;
     for (int in_key : input_keys)
     {
-        forward_order.push_back(in_key);
-        added_keys.insert(in_key);
+        node_levels[in_key] = 0;
     }
-    // work through hidden nodes to find which ones depend on eachother
-    std::set<int> hidden_key_copy(hidden_keys);
-    while (!hidden_key_copy.empty())
+    // every node joins the level after the last of its enabled inputs
+    for (const std::pair<int, int> &node : ordered_nodes)
     {
-        std::set<int> keys_added_this_it = {};
-        for (int hidden_key : hidden_key_copy)
+        const int node_key = node.second;
+        // nodes that reach no output can't change the outputs, leave them out of the network
+        if (input_keys.count(node_key) || !reaches_output(node_key))
+        {
+            continue;
+        }
+        size_t level = 1;
+        for (const std::pair<int, int> &edge : get_input_edges(node_key))
         {
-            bool add_node = true;
-            // if one of this nodes inputs is not in the current forward order then skip it for now
-            for (int input : node_inputs_map[hidden_key])
+            if (connections.at({edge.second, node_key}).enabled)
             {
-                if (added_keys.count(input) == 0)
-                {
-                    add_node = false;
-                    break;
-                }
+                level = std::max(level, node_levels[edge.second] + 1);
             }
+        }
+        node_levels[node_key] = level;
+        if (level >= forward_levels.size())
+        {
+            forward_levels.resize(level + 1);
+        }
+        forward_levels[level].push_back(node_key);
+    }
+    for (std::vector<int> &level : forward_levels)
+    {
+        std::sort(level.begin(), level.end());
+    }
+    compile_network();
+    activated = true;
+}
+/**
+ * @brief flattens the ordered nodes into a FeedForwardNetwork so forward never touches the gene maps
+ * Computes in linear time O(N) (O(num_nodes) + O(num_connections))
+ */
+void Genome::compile_network()
+{
+    std::shared_ptr<FeedForwardNetwork> net = std::make_shared<FeedForwardNetwork>(get_num_inputs(), config->activation_precision);
+    // inputs take the first dense indices in the order the input vector is read
+    std::unordered_map<int, int> dense_index;
+    int input_index = 0;
+    for (int in_key : input_keys)
+    {
+        dense_index[in_key] = input_index++;
+    }
 
-            if (add_node)
+    // levels after the first (the inputs) are computed in order
+    for (size_t level = 1; level < forward_levels.size(); level++)
+    {
+        // group the level by activation so it is activated in as few array passes as possible
+        std::vector<int> level_keys = forward_levels[level];
+        std::stable_sort(level_keys.begin(), level_keys.end(), [this](int a, int b)
+                         { return nodes.at(a).activation < nodes.at(b).activation; });
+        net->add_level();
+        std::vector<std::pair<int, int>> level_indices;
+        for (int node_key : level_keys)
+        {
+            const NodeGene &this_node = nodes.at(node_key);
+            int node_index = net->add_node(this_node.bias, this_node.response, this_node.activation, this_node.aggregation);
+            for (const std::pair<int, int> &edge : get_input_edges(node_key))
             {
-                forward_order.push_back(hidden_key);
-                added_keys.insert(hidden_key);
-                int complete_key = hidden_key;
-                // Continuously loop thorugh hidden keys until theyre done
-                keys_added_this_it.insert(complete_key);
+                std::unordered_map<int, int>::iterator source = dense_index.find(edge.second);
+                const ConnectionGene &conn = connections.at({edge.second, node_key});
+                // inputs that are never computed would only ever contribute 0
+                if (source == dense_index.end() || !conn.enabled)
+                {
+                    continue;
+                }
+                net->add_edge(source->second, conn.weight);
             }
+            level_indices.push_back({node_key, node_index});
         }
-        // If we are unable to add any more hidden nodes to the order then we are done
-        if (keys_added_this_it.size() == 0)
-        {
-            break;
-        }
-        for (int key_to_remove : keys_added_this_it)
+        // nodes of a level never feed each other, so they only become sources afterwards
+        for (std::pair<int, int> &index : level_indices)
         {
-            hidden_key_copy.erase(key_to_remove);
+            dense_index[index.first] = index.second;
         }
     }
-    // outputs dont depend on eachother so you can just add them all last
+
     for (int out_key : output_keys)
     {
-        forward_order.push_back(out_key);
+        net->add_output(dense_index[out_key]);
     }
-    activated = true;
+    network = net;
 }
 
 /**
- * @brief Computes the difference between this genome and the other
+ * @brief gives every node a dense index for the recurrent networks, inputs first and
+ * then every other node grouped by activation, so every group is activated in one array pass
  *
- * @param other
- * @return float
+ * @param dense_index receives the dense index of every node key
+ * @return std::vector<std::pair<valid_activations, int>> activation and key of every evaluated node in dense order
  */
-float Genome::distance(Genome_ptr &other)
+std::vector<std::pair<valid_activations, int>> Genome::order_recurrent_nodes(std::unordered_map<int, int> &dense_index)
 {
-    // Compute node gene distance component.
-    float node_distance = 0.0F;
+    std::vector<std::pair<valid_activations, int>> evaluated;
+    for (const NodeGene &node : nodes)
+    {
+        if (!input_keys.count(node.key))
+        {
+            evaluated.push_back({node.activation, node.key});
+        }
+    }
+    std::sort(evaluated.begin(), evaluated.end());
 
-    // if the other genome has nodes
-    if (nodes.size() > 0 || other->nodes.size() > 0)
+    // inputs take the first dense indices in the order the input vector is read
+    int index = 0;
+    for (int in_key : input_keys)
+    {
+        dense_index[in_key] = index++;
+    }
+    for (std::pair<valid_activations, int> &node : evaluated)
     {
-        float disjoint_nodes = 0.0F;
+        dense_index[node.second] = index++;
+    }
+    return evaluated;
+}
+/**
+ * @brief flattens every node into a RecurrentNetwork with fresh (zero) state
+ * Computes in linear time O(N) (O(num_nodes) + O(num_connections))
+ */
+void Genome::compile_recurrent_network()
+{
+    std::unordered_map<int, int> dense_index;
+    std::vector<std::pair<valid_activations, int>> evaluated = order_recurrent_nodes(dense_index);
 
-        for (std::pair<const int, NodeGene_ptr> &n2 : other->nodes)
+    RecurrentNetwork_ptr net = std::make_shared<RecurrentNetwork>(get_num_inputs(), evaluated.size(), config->activation_precision);
+    for (std::pair<valid_activations, int> &node : evaluated)
+    {
+        const int node_key = node.second;
+        const NodeGene &this_node = nodes.at(node_key);
+        net->add_node(this_node.bias, this_node.response, node.first, this_node.aggregation);
+        for (const std::pair<int, int> &edge : get_input_edges(node_key))
         {
-            if (!nodes.count(n2.first))
+            std::unordered_map<int, int>::iterator source = dense_index.find(edge.second);
+            const ConnectionGene &conn = connections.at({edge.second, node_key});
+            if (source == dense_index.end() || !conn.enabled)
             {
-                disjoint_nodes += 1.0F;
+                continue;
             }
+            net->add_edge(source->second, conn.weight);
         }
+    }
 
-        for (std::pair<const int, NodeGene_ptr> &n1 : nodes)
-        {
+    for (int out_key : output_keys)
+    {
+        net->add_output(dense_index[out_key]);
+    }
+    recurrent_network = net;
+}
+/**
+ * @brief builds a continuous-time version of this genome with every state at 0
+ * Each node integrates with its own time_constant
+ *
+ * @param integrator fixed step integrator the CTRNN advances with
+ * @return CTRNN_ptr
+ */
+CTRNN_ptr Genome::create_ctrnn(ctrnn_integrator integrator)
+{
+    std::unordered_map<int, int> dense_index;
+    std::vector<std::pair<valid_activations, int>> evaluated = order_recurrent_nodes(dense_index);
 
-            if (!other->nodes.count(n1.first))
-            {
-                disjoint_nodes += 1.0F;
-            }
-            else
+    CTRNN_ptr net = std::make_shared<CTRNN>(get_num_inputs(), evaluated.size(), integrator, config->activation_precision);
+    for (std::pair<valid_activations, int> &node : evaluated)
+    {
+        const int node_key = node.second;
+        const NodeGene &this_node = nodes.at(node_key);
+        net->add_node(this_node.bias, this_node.response, this_node.time_constant, node.first, this_node.aggregation);
+        for (const std::pair<int, int> &edge : get_input_edges(node_key))
+        {
+            std::unordered_map<int, int>::iterator source = dense_index.find(edge.second);
+            const ConnectionGene &conn = connections.at({edge.second, node_key});
+            if (source == dense_index.end() || !conn.enabled)
             {
-                // Homologous genes compute their own distance value.
-                NodeGene_ptr n2 = other->nodes[n1.first];
-
-                node_distance += n1.second->distance(n2, config->compatibility_weight_coefficient);
+                continue;
             }
+            net->add_edge(source->second, conn.weight);
         }
-        float max_nodes = fmax(nodes.size(), other->nodes.size());
-        node_distance = (node_distance + (config->compatibility_disjoint_coefficient * disjoint_nodes)) / max_nodes;
     }
 
-    // Compute node gene distance component.
-    float connection_distance = 0.0F;
-    if (connections.size() > 0 || other->connections.size() > 0)
+    for (int out_key : output_keys)
     {
-        float disjoint_connections = 0.0F;
-        for (std::pair<const std::pair<int, int>, ConnectionGene_ptr> &c2 : other->connections)
+        net->add_output(dense_index[out_key]);
+    }
+    return net;
+}
+
+/**
+ * @brief distance between two sorted gene vectors, found by merging them in one pass
+ * Homologous genes compute their own distance, every disjoint gene adds disjoint_coefficient
+ *
+ * @param genes1
+ * @param genes2
+ * @param weight_coefficient
+ * @param disjoint_coefficient
+ * @return float distance normalized by the size of the larger vector
+ */
+template <typename Gene>
+static float gene_distance(const GeneVector<Gene> &genes1, const GeneVector<Gene> &genes2, float weight_coefficient, float disjoint_coefficient)
+{
+    if (genes1.empty() && genes2.empty())
+    {
+        return 0.0F;
+    }
+
+    float homologous_distance = 0.0F;
+    float disjoint_genes = 0.0F;
+    typename GeneVector<Gene>::const_iterator g1 = genes1.begin();
+    typename GeneVector<Gene>::const_iterator g2 = genes2.begin();
+    size_t visited1 = 0;
+    size_t visited2 = 0;
+    while (g1 != genes1.end() && g2 != genes2.end())
+    {
+        if (g1->key < g2->key)
         {
-            if (!connections.count(c2.first))
-            {
-                disjoint_connections += 1.0F;
-            }
+            disjoint_genes += 1.0F;
+            g1++;
+            visited1++;
         }
-
-        for (std::pair<const std::pair<int, int>, ConnectionGene_ptr> &c1 : connections)
+        else if (g2->key < g1->key)
         {
-            if (!other->connections.count(c1.first))
-            {
-                disjoint_connections += 1.0F;
-            }
-            else
-            {
-                // Homologous genes compute their own distance value.
-                ConnectionGene_ptr &c2 = other->connections[c1.first];
-                connection_distance += c1.second->distance(c2, config->compatibility_weight_coefficient);
-            }
+            disjoint_genes += 1.0F;
+            g2++;
+            visited2++;
+        }
+        else
+        {
+            homologous_distance += g1->distance(*g2, weight_coefficient);
+            g1++;
+            g2++;
+            visited1++;
+            visited2++;
         }
-
-        float max_connections = fmax(connections.size(), other->connections.size());
-        connection_distance = (connection_distance + (config->compatibility_disjoint_coefficient * disjoint_connections)) / max_connections;
     }
+    // whatever is left of either vector has no partner
+    disjoint_genes += static_cast<float>((genes1.size() - visited1) + (genes2.size() - visited2));
+
+    float max_genes = fmax(genes1.size(), genes2.size());
+    return (homologous_distance + disjoint_coefficient * disjoint_genes) / max_genes;
+}
+/**
+ * @brief Computes the difference between this genome and the other
+ *
+ * @param other
+ * @return float
+ */
+float Genome::distance(Genome_ptr &other)
+{
+    float node_distance = gene_distance(nodes, other->nodes, config->compatibility_weight_coefficient, config->compatibility_disjoint_coefficient);
+    float connection_distance = gene_distance(connections, other->connections, config->compatibility_weight_coefficient, config->compatibility_disjoint_coefficient);
 
     float distance = std::fabs(node_distance + connection_distance);
     return distance;
@@ -826,68 +1551,114 @@ float Genome::distance(Genome_ptr &other)
 
 /**
  * @brief computes the result of providing the given inputs to the network
+ * Recurrent genomes advance their state by one step on every call
  *
  * @param inputs
  * @return std::vector<float>
  */
-std::vector<float> Genome::forward(std::vector<float> inputs)
+std::vector<float> Genome::forward(const std::vector<float> &inputs)
 {
     if (!activated)
     {
         throw std::runtime_error("Genome must be activated before calling forward");
     }
 
-    if (inputs.size() != input_keys.size())
+    if (!config->feed_forward)
     {
-        throw std::invalid_argument("Incorrect number of inputs provided, given: " +
-                                    std::to_string(inputs.size()) +
-                                    ", need: " +
-                                    std::to_string(input_keys.size()));
+        return recurrent_network->forward(inputs);
     }
-
-    std::map<int, float> input_values;
-    std::set<int> node_inputs;
-    float node_value;
-    for (int node_key : forward_order)
+    return network->forward(inputs);
+}
+/**
+ * @brief computes the result of providing the given inputs to the network into outputs
+ * without allocating, see FeedForwardNetwork::forward
+ *
+ * @param inputs num_inputs values
+ * @param outputs receives num_outputs values
+ */
+void Genome::forward(std::span<const float> inputs, std::span<float> outputs)
+{
+    if (!activated)
     {
-
-        NodeGene_ptr this_node = nodes[node_key];
-        float bias = this_node->get_attribute("bias")->get_float_value();
-        float response = this_node->get_attribute("response")->get_float_value();
-        std::string activation_method = this_node->get_attribute("activation")->get_string_value();
-        std::string aggregation_method = this_node->get_attribute("aggregation")->get_string_value();
-        // If this node is an input pull it's value from the inputs
-        std::set<int>::iterator input_ind = input_keys.find(node_key);
-        if (input_ind == input_keys.end())
-        {
-            // If this node is not an input, aggregate the node's inputs to be the value
-            node_inputs = node_inputs_map[node_key];
-            std::vector<float> agg_vec;
-            for (int node_input_id : node_inputs)
-            {
-                std::pair<int, int> con(node_input_id, node_key);
-                float w = connections[con]->get_attribute("weight")->get_float_value();
-                agg_vec.push_back(input_values[node_input_id] * w);
-            }
-            node_value = aggregate_vector(agg_vec, aggregation_method);
-            // Apply activation function to the value
-            node_value = activate_value((bias + (response * node_value)), activation_method);
-        }
-        else
-        {
-            node_value = inputs[std::distance(input_keys.begin(), input_ind)];
-        }
-
-        input_values[node_key] = node_value;
+        throw std::runtime_error("Genome must be activated before calling forward");
     }
-    std::vector<float> outputs;
 
-    for (int out_key : output_keys)
+    if (!config->feed_forward)
     {
-        outputs.push_back(input_values[out_key]);
+        recurrent_network->forward(inputs, outputs);
+        return;
+    }
+    network->forward(inputs, outputs);
+}
+/**
+ * @brief computes the result of providing a row-major batch of inputs to the network
+ * For recurrent genomes row b is the next input of sequence b, see RecurrentNetwork::forward_batch
+ *
+ * @param inputs row-major batch_size x num_inputs matrix
+ * @param batch_size number of rows in inputs
+ * @return std::vector<float> row-major batch_size x num_outputs matrix
+ */
+std::vector<float> Genome::forward_batch(const std::vector<float> &inputs, int batch_size)
+{
+    if (!activated)
+    {
+        throw std::runtime_error("Genome must be activated before calling forward_batch");
     }
 
-    return outputs;
+    if (!config->feed_forward)
+    {
+        return recurrent_network->forward_batch(inputs, batch_size);
+    }
+    return network->forward_batch(inputs, batch_size);
+}
+/**
+ * @brief gets the compiled network produced by the last call to activate
+ *
+ * @return FeedForwardNetwork_ptr
+ */
+FeedForwardNetwork_ptr Genome::get_network()
+{
+    if (!activated)
+    {
+        throw std::runtime_error("Genome must be activated before getting its network");
+    }
+    if (!config->feed_forward)
+    {
+        throw std::runtime_error("Recurrent genomes compile a RecurrentNetwork, use get_recurrent_network");
+    }
+    return network;
+}
+/**
+ * @brief gets the recurrent network (and its state) produced by the last call to activate
+ *
+ * @return RecurrentNetwork_ptr
+ */
+RecurrentNetwork_ptr Genome::get_recurrent_network()
+{
+    if (!activated)
+    {
+        throw std::runtime_error("Genome must be activated before getting its network");
+    }
+    if (config->feed_forward)
+    {
+        throw std::runtime_error("Feed forward genomes compile a FeedForwardNetwork, use get_network");
+    }
+    return recurrent_network;
+}
+/**
+ * @brief clears the state kept between forward calls of a recurrent genome
+ * Feed forward genomes have no state so this does nothing for them
+ */
+void Genome::reset()
+{
+    if (!activated)
+    {
+        throw std::runtime_error("Genome must be activated before calling reset");
+    }
+    if (!config->feed_forward)
+    {
+        recurrent_network->reset();
+    }
 }
 
 /**
@@ -901,18 +1672,16 @@ std::string Genome::to_string()
     out += "Genome: " + std::to_string(key) + "\n";
     out += "  Fitness: " + std::to_string(fitness) + "\n";
     out += "  Nodes:\n";
-    for (std::pair<const int, NodeGene_ptr> &ngit : nodes)
+    for (const NodeGene &n : nodes)
     {
-        const int nid = ngit.first;
-        NodeGene_ptr n = ngit.second;
-        out += "    " + std::to_string(nid) + " DefaultNodeGene(key=" + std::to_string(n->key) + ", bias=" + n->get_attribute("bias")->get_string_value() + ", response=" + n->get_attribute("response")->get_string_value() + ", activation=" + n->get_attribute("activation")->get_string_value() + ", aggregation=" + n->get_attribute("aggregation")->get_string_value() + ")\n";
+        const int nid = n.key;
+        out += "    " + std::to_string(nid) + " DefaultNodeGene(key=" + std::to_string(n.key) + ", bias=" + std::to_string(n.bias) + ", response=" + std::to_string(n.response) + ", activation=" + activation_name(n.activation) + ", aggregation=" + aggregation_name(n.aggregation) + ")\n";
     }
     out += "  Connections:\n";
-    for (std::pair<const std::pair<int, int>, ConnectionGene_ptr> &cgit : connections)
+    for (const ConnectionGene &n : connections)
     {
-        const std::pair<int, int> cid = cgit.first;
-        ConnectionGene_ptr n = cgit.second;
-        out += "    (" + std::to_string(cid.first) + ", " + std::to_string(cid.second) + ") DefaultConnectionGene(key=(" + std::to_string(n->key.first) + ", " + std::to_string(n->key.second) + "), weight=" + n->get_attribute("weight")->get_string_value() + ", enable=" + n->get_attribute("enable")->get_string_value() + ")\n";
+        const std::pair<int, int> cid = n.key;
+        out += "    (" + std::to_string(cid.first) + ", " + std::to_string(cid.second) + ") DefaultConnectionGene(key=(" + std::to_string(n.key.first) + ", " + std::to_string(n.key.second) + "), weight=" + std::to_string(n.weight) + ", enable=" + (n.enabled ? "true" : "false") + ")\n";
     }
 
     return out;
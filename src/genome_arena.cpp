@@ -0,0 +1,84 @@
+#include "genome_arena.h"
+
+#include <cstdint>
+#include <algorithm>
+
+GenomeArena::GenomeArena(size_t _slab_size)
+{
+    slab_size = std::max<size_t>(_slab_size, 64);
+    current_slab = 0;
+    offset = 0;
+    allocated = 0;
+}
+
+/**
+ * @brief Recycle every slab, all memory previously handed out becomes invalid
+ * Only call once nothing allocated from the arena is alive anymore
+ */
+void GenomeArena::reset()
+{
+    current_slab = 0;
+    offset = 0;
+    allocated = 0;
+}
+
+/**
+ * @brief number of bytes handed out since the last reset
+ *
+ * @return size_t
+ */
+size_t GenomeArena::bytes_allocated() const
+{
+    return allocated;
+}
+
+/**
+ * @brief number of bytes held in slabs, kept across resets
+ *
+ * @return size_t
+ */
+size_t GenomeArena::bytes_reserved() const
+{
+    size_t reserved = 0;
+    for (const std::pair<std::unique_ptr<std::byte[]>, size_t> &slab : slabs)
+    {
+        reserved += slab.second;
+    }
+    return reserved;
+}
+
+void *GenomeArena::do_allocate(size_t bytes, size_t alignment)
+{
+    // Find the first slab starting from the current one that fits the aligned request
+    while (current_slab < slabs.size())
+    {
+        std::byte *base = slabs[current_slab].first.get();
+        size_t aligned = (reinterpret_cast<uintptr_t>(base + offset) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+        size_t start = aligned - reinterpret_cast<uintptr_t>(base);
+        if (start + bytes <= slabs[current_slab].second)
+        {
+            offset = start + bytes;
+            allocated += bytes;
+            return base + start;
+        }
+        current_slab++;
+        offset = 0;
+    }
+
+    // Nothing left, add a slab large enough for the request
+    size_t size = std::max(slab_size, bytes + alignment);
+    slabs.emplace_back(std::make_unique<std::byte[]>(size), size);
+    current_slab = slabs.size() - 1;
+    offset = 0;
+    return do_allocate(bytes, alignment);
+}
+
+void GenomeArena::do_deallocate([[maybe_unused]] void *p, [[maybe_unused]] size_t bytes, [[maybe_unused]] size_t alignment)
+{
+    // memory is only reclaimed in bulk by reset()
+}
+
+bool GenomeArena::do_is_equal(const std::pmr::memory_resource &other) const noexcept
+{
+    return this == &other;
+}
@@ -0,0 +1,59 @@
+#include "innovation_tracker.h"
+
+#include <functional>
+
+/**
+ * @brief Construct a new Innovation Tracker:: Innovation Tracker object
+ *
+ * @param first_node_key first key handed out, greater than every key of the initial genomes
+ */
+InnovationTracker::InnovationTracker(int first_node_key)
+    : next_node_key(first_node_key)
+{
+}
+
+/**
+ * @brief Gets a node key no genome has used before
+ *
+ * @return int
+ */
+int InnovationTracker::new_node_key()
+{
+    return next_node_key.fetch_add(1);
+}
+
+/**
+ * @brief Gets the key of the node that splits connection, the same key for every
+ * genome that splits connection during the current generation
+ *
+ * @param connection
+ * @return int
+ */
+int InnovationTracker::split_node_key(std::pair<int, int> connection)
+{
+    size_t hash = std::hash<int>()(connection.first) * 31 + std::hash<int>()(connection.second);
+    Shard &shard = shards[hash % num_shards];
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    std::map<std::pair<int, int>, int>::iterator it = shard.split_nodes.find(connection);
+    if (it != shard.split_nodes.end())
+    {
+        return it->second;
+    }
+    int node_key = new_node_key();
+    shard.split_nodes.emplace(connection, node_key);
+    return node_key;
+}
+
+/**
+ * @brief Forgets the splits of the previous generation, splitting the same
+ * connection again creates a new innovation. Not safe to call while genomes mutate
+ */
+void InnovationTracker::next_generation()
+{
+    for (Shard &shard : shards)
+    {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.split_nodes.clear();
+    }
+}
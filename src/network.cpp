@@ -0,0 +1,836 @@
+#include "network.h"
+
+#include <vector>
+#include <span>
+#include <string>
+#include <stdexcept>
+#include <algorithm>
+#include "activations.h"
+#include "activation_kernels.h"
+#include "aggregations.h"
+
+/**
+ * @brief activates n values that share the same activation in place
+ *
+ * @param activation
+ * @param precision
+ * @param run_values
+ * @param n
+ */
+static void activate_run(valid_activations activation, valid_precisions precision, float *run_values, int n)
+{
+    activate_array(activation, precision, run_values, n);
+}
+
+/**
+ * @brief aggregates the weighted inputs of one node for a whole batch
+ *
+ * @param aggregation
+ * @param sources dense index of the node feeding each incoming edge
+ * @param weights weight of each incoming edge
+ * @param fan_in number of incoming edges
+ * @param values node-major values of every node, batch_size per node
+ * @param batch_size
+ * @param node_values receives the batch_size aggregated values
+ * @param agg_vec scratch for aggregations that need every input at once
+ */
+static void aggregate_batch(valid_aggregations aggregation, const int *sources, const float *weights, int fan_in,
+                            const float *values, int batch_size, float *node_values, std::vector<float> &agg_vec)
+{
+    // A node without any (enabled) inputs aggregates to nothing
+    std::fill(node_values, node_values + batch_size, 0.0F);
+    if (fan_in)
+    {
+        switch (aggregation)
+        {
+        case (valid_aggregations::sum):
+        case (valid_aggregations::mean):
+            for (int e = 0; e < fan_in; e++)
+            {
+                const float *source_values = &values[sources[e] * batch_size];
+                const float w = weights[e];
+                for (int b = 0; b < batch_size; b++)
+                {
+                    node_values[b] += source_values[b] * w;
+                }
+            }
+            if (aggregation == valid_aggregations::mean)
+            {
+                const float inv_fan_in = 1.0F / static_cast<float>(fan_in);
+                for (int b = 0; b < batch_size; b++)
+                {
+                    node_values[b] *= inv_fan_in;
+                }
+            }
+            break;
+        case (valid_aggregations::max):
+        case (valid_aggregations::min):
+        {
+            const bool is_max = (aggregation == valid_aggregations::max);
+            const float *first_values = &values[sources[0] * batch_size];
+            for (int b = 0; b < batch_size; b++)
+            {
+                node_values[b] = first_values[b] * weights[0];
+            }
+            for (int e = 1; e < fan_in; e++)
+            {
+                const float *source_values = &values[sources[e] * batch_size];
+                const float w = weights[e];
+                for (int b = 0; b < batch_size; b++)
+                {
+                    const float v = source_values[b] * w;
+                    node_values[b] = is_max ? std::max(node_values[b], v) : std::min(node_values[b], v);
+                }
+            }
+            break;
+        }
+        default:
+            // Order statistics need every weighted input of a sample at once
+            for (int b = 0; b < batch_size; b++)
+            {
+                agg_vec.clear();
+                for (int e = 0; e < fan_in; e++)
+                {
+                    agg_vec.push_back(values[sources[e] * batch_size + b] * weights[e]);
+                }
+                node_values[b] = median_aggregate(agg_vec);
+            }
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Construct a new, empty Feed Forward Network object
+ *
+ * @param _num_inputs number of network inputs (dense indices [0, _num_inputs))
+ * @param _precision how closely the transcendental activations are computed
+ */
+FeedForwardNetwork::FeedForwardNetwork(int _num_inputs, valid_precisions _precision)
+{
+    num_inputs = _num_inputs;
+    precision = _precision;
+    num_outputs = 0;
+    num_nodes = _num_inputs;
+    edge_offsets = {0};
+    level_offsets = {0};
+}
+
+/**
+ * @brief gets the number of nodes that are computed (every node that is not an input)
+ *
+ * @return int
+ */
+int FeedForwardNetwork::get_num_evaluated()
+{
+    return num_nodes - num_inputs;
+}
+
+/**
+ * @brief gets the number of topological levels of evaluated nodes
+ *
+ * @return int
+ */
+int FeedForwardNetwork::get_num_levels() const
+{
+    return static_cast<int>(level_offsets.size()) - 1;
+}
+
+/**
+ * @brief starts a new level, nodes added afterwards may read any node of the previous levels
+ */
+void FeedForwardNetwork::add_level()
+{
+    level_offsets.push_back(level_offsets.back());
+}
+
+/**
+ * @brief appends a node to the current level, edges added afterwards feed into this node
+ *
+ * @param bias
+ * @param response
+ * @param activation
+ * @param aggregation
+ * @return int dense index of the new node
+ */
+int FeedForwardNetwork::add_node(float bias, float response, valid_activations activation, valid_aggregations aggregation)
+{
+    if (level_offsets.size() < 2)
+    {
+        throw std::runtime_error("add_level must be called before adding nodes");
+    }
+    node_bias.push_back(bias);
+    node_response.push_back(response);
+    node_activation.push_back(activation);
+    node_aggregation.push_back(aggregation);
+    edge_offsets.push_back(edge_offsets.back());
+    level_offsets.back()++;
+    return num_nodes++;
+}
+
+/**
+ * @brief adds an incoming edge to the most recently added node
+ *
+ * @param source dense index of the node feeding the edge
+ * @param weight
+ */
+void FeedForwardNetwork::add_edge(int source, float weight)
+{
+    // the current level starts at dense index num_inputs + level_offsets[num_levels - 1]
+    if (source < 0 || source >= num_inputs + level_offsets[level_offsets.size() - 2])
+    {
+        throw std::invalid_argument("Edge source " + std::to_string(source) + " must be computed in an earlier level than its target");
+    }
+    edge_sources.push_back(source);
+    edge_weights.push_back(weight);
+    edge_offsets.back()++;
+}
+
+/**
+ * @brief marks the node at node_index as the next output of the network
+ *
+ * @param node_index
+ */
+void FeedForwardNetwork::add_output(int node_index)
+{
+    output_indices.push_back(node_index);
+    num_outputs++;
+}
+
+/**
+ * @brief computes the result of providing the given inputs to the network
+ *
+ * @param inputs
+ * @return std::vector<float>
+ */
+std::vector<float> FeedForwardNetwork::forward(const std::vector<float> &inputs) const
+{
+    std::vector<float> outputs(num_outputs);
+    forward(std::span<const float>(inputs), std::span<float>(outputs));
+    return outputs;
+}
+
+/**
+ * @brief computes the result of providing the given inputs to the network into outputs
+ * Node values live in a per-thread scratch buffer that only grows, so once it fits the
+ * largest network evaluated on the thread this does not allocate
+ *
+ * @param inputs num_inputs values
+ * @param outputs receives num_outputs values
+ */
+void FeedForwardNetwork::forward(std::span<const float> inputs, std::span<float> outputs) const
+{
+    if (inputs.size() != static_cast<size_t>(num_inputs))
+    {
+        throw std::invalid_argument("Incorrect number of inputs provided, given: " +
+                                    std::to_string(inputs.size()) +
+                                    ", need: " +
+                                    std::to_string(num_inputs));
+    }
+    if (outputs.size() != static_cast<size_t>(num_outputs))
+    {
+        throw std::invalid_argument("Incorrect number of outputs provided, given: " +
+                                    std::to_string(outputs.size()) +
+                                    ", need: " +
+                                    std::to_string(num_outputs));
+    }
+
+    thread_local std::vector<float> values;
+    thread_local std::vector<float> agg_vec;
+    if (values.size() < static_cast<size_t>(num_nodes))
+    {
+        values.resize(num_nodes);
+    }
+    std::copy(inputs.begin(), inputs.end(), values.begin());
+
+    for (size_t level = 0; level + 1 < level_offsets.size(); level++)
+    {
+        const int first = level_offsets[level];
+        const int last = level_offsets[level + 1];
+        // aggregate the whole level, then activate it in one pass
+        for (int i = first; i < last; i++)
+        {
+            const valid_aggregations aggregation = node_aggregation[i];
+            const int first_edge = edge_offsets[i];
+            const int last_edge = edge_offsets[i + 1];
+            float node_value;
+            if (is_streamable(aggregation))
+            {
+                // fold the weighted inputs as they are read
+                float acc = aggregate_identity(aggregation);
+                for (int e = first_edge; e < last_edge; e++)
+                {
+                    acc = aggregate_fold(aggregation, acc, values[edge_sources[e]] * edge_weights[e]);
+                }
+                node_value = aggregate_finish(aggregation, acc, last_edge - first_edge);
+            }
+            else
+            {
+                agg_vec.clear();
+                for (int e = first_edge; e < last_edge; e++)
+                {
+                    agg_vec.push_back(values[edge_sources[e]] * edge_weights[e]);
+                }
+                node_value = agg_vec.empty() ? 0.0F : median_aggregate(agg_vec);
+            }
+            values[num_inputs + i] = node_bias[i] + node_response[i] * node_value;
+        }
+        activate_level(&values[num_inputs + first], first, last);
+    }
+
+    for (int o = 0; o < num_outputs; o++)
+    {
+        outputs[o] = values[output_indices[o]];
+    }
+}
+
+/**
+ * @brief computes the result of the network for a batch of input rows in one pass
+ *
+ * Each node is computed for the whole batch before moving on to the next node, so
+ * the graph is traversed once per batch instead of once per sample.
+ *
+ * @param inputs row-major batch_size x num_inputs matrix
+ * @param batch_size number of rows in inputs
+ * @return std::vector<float> row-major batch_size x num_outputs matrix
+ */
+std::vector<float> FeedForwardNetwork::forward_batch(const std::vector<float> &inputs, int batch_size) const
+{
+    if (batch_size < 0 || inputs.size() != static_cast<size_t>(batch_size) * num_inputs)
+    {
+        throw std::invalid_argument("Incorrect number of inputs provided, given: " +
+                                    std::to_string(inputs.size()) +
+                                    ", need: " +
+                                    std::to_string(batch_size) + " x " + std::to_string(num_inputs));
+    }
+
+    // Node-major values, the batch of node n is stored in [n * batch_size, (n + 1) * batch_size)
+    std::vector<float> values(static_cast<size_t>(num_nodes) * batch_size);
+    for (int b = 0; b < batch_size; b++)
+    {
+        for (int in = 0; in < num_inputs; in++)
+        {
+            values[in * batch_size + b] = inputs[b * num_inputs + in];
+        }
+    }
+
+    std::vector<float> agg_vec;
+    const int num_evaluated = num_nodes - num_inputs;
+    for (int i = 0; i < num_evaluated; i++)
+    {
+        float *node_values = &values[(num_inputs + i) * batch_size];
+        const int first_edge = edge_offsets[i];
+        const int last_edge = edge_offsets[i + 1];
+        aggregate_batch(node_aggregation[i], edge_sources.data() + first_edge, edge_weights.data() + first_edge, last_edge - first_edge,
+                        values.data(), batch_size, node_values, agg_vec);
+
+        const float bias = node_bias[i];
+        const float response = node_response[i];
+        for (int b = 0; b < batch_size; b++)
+        {
+            node_values[b] = bias + response * node_values[b];
+        }
+        activate_run(node_activation[i], precision, node_values, batch_size);
+    }
+
+    std::vector<float> outputs(static_cast<size_t>(batch_size) * num_outputs);
+    for (int o = 0; o < num_outputs; o++)
+    {
+        const float *output_values = &values[output_indices[o] * batch_size];
+        for (int b = 0; b < batch_size; b++)
+        {
+            outputs[b * num_outputs + o] = output_values[b];
+        }
+    }
+    return outputs;
+}
+
+/**
+ * @brief activates the aggregated values of evaluated nodes [first, last) of one level
+ * Nodes of a level are grouped by activation, so each group is one array pass
+ *
+ * @param level_values value of evaluated node first, followed by the rest of the level
+ * @param first
+ * @param last
+ */
+void FeedForwardNetwork::activate_level(float *level_values, int first, int last) const
+{
+    int run_start = first;
+    for (int i = first + 1; i <= last; i++)
+    {
+        if (i == last || node_activation[i] != node_activation[run_start])
+        {
+            activate_run(node_activation[run_start], precision, level_values + (run_start - first), i - run_start);
+            run_start = i;
+        }
+    }
+}
+
+/// ------------ Recurrent Network ------------///
+
+/**
+ * @brief Construct a new, empty Recurrent Network object
+ *
+ * @param _num_inputs number of network inputs (dense indices [0, _num_inputs))
+ * @param _num_evaluated number of nodes that will be added with add_node
+ * @param _precision how closely the transcendental activations are computed
+ */
+RecurrentNetwork::RecurrentNetwork(int _num_inputs, int _num_evaluated, valid_precisions _precision)
+{
+    num_inputs = _num_inputs;
+    num_outputs = 0;
+    num_nodes = _num_inputs + _num_evaluated;
+    precision = _precision;
+    edge_offsets = {0};
+    batch_size = 1;
+    reset();
+}
+
+/**
+ * @brief gets the number of nodes that are computed (every node that is not an input)
+ *
+ * @return int
+ */
+int RecurrentNetwork::get_num_evaluated() const
+{
+    return num_nodes - num_inputs;
+}
+
+/**
+ * @brief gets the number of sequences the state is currently kept for
+ *
+ * @return int
+ */
+int RecurrentNetwork::get_batch_size() const
+{
+    return batch_size;
+}
+
+/**
+ * @brief appends the next evaluated node, edges added afterwards feed into this node
+ *
+ * @param bias
+ * @param response
+ * @param activation
+ * @param aggregation
+ * @return int dense index of the new node
+ */
+int RecurrentNetwork::add_node(float bias, float response, valid_activations activation, valid_aggregations aggregation)
+{
+    if (node_bias.size() >= static_cast<size_t>(get_num_evaluated()))
+    {
+        throw std::runtime_error("All " + std::to_string(get_num_evaluated()) + " nodes of the network were already added");
+    }
+    node_bias.push_back(bias);
+    node_response.push_back(response);
+    node_activation.push_back(activation);
+    node_aggregation.push_back(aggregation);
+    edge_offsets.push_back(edge_offsets.back());
+    return num_inputs + static_cast<int>(node_bias.size()) - 1;
+}
+
+/**
+ * @brief adds an incoming edge to the most recently added node, the source can be any node
+ * (including later nodes and the node itself), it is read from the previous step
+ *
+ * @param source dense index of the node feeding the edge
+ * @param weight
+ */
+void RecurrentNetwork::add_edge(int source, float weight)
+{
+    if (source < 0 || source >= num_nodes || node_bias.empty())
+    {
+        throw std::invalid_argument("Edge source " + std::to_string(source) + " is not a node of the network");
+    }
+    edge_sources.push_back(source);
+    edge_weights.push_back(weight);
+    edge_offsets.back()++;
+}
+
+/**
+ * @brief marks the node at node_index as the next output of the network
+ *
+ * @param node_index
+ */
+void RecurrentNetwork::add_output(int node_index)
+{
+    output_indices.push_back(node_index);
+    num_outputs++;
+}
+
+/**
+ * @brief clears the state of every node (of every sequence) back to 0
+ */
+void RecurrentNetwork::reset()
+{
+    values.assign(static_cast<size_t>(num_nodes) * batch_size, 0.0F);
+    next_values.assign(static_cast<size_t>(num_nodes) * batch_size, 0.0F);
+}
+
+/**
+ * @brief advances every node of every sequence by one synchronous step
+ * Every node reads the values its sources had after the previous step
+ */
+void RecurrentNetwork::step()
+{
+    const int num_evaluated = get_num_evaluated();
+    for (int i = 0; i < num_evaluated; i++)
+    {
+        float *node_values = &next_values[static_cast<size_t>(num_inputs + i) * batch_size];
+        const int first_edge = edge_offsets[i];
+        const int last_edge = edge_offsets[i + 1];
+        aggregate_batch(node_aggregation[i], edge_sources.data() + first_edge, edge_weights.data() + first_edge, last_edge - first_edge,
+                        values.data(), batch_size, node_values, agg_vec);
+
+        const float bias = node_bias[i];
+        const float response = node_response[i];
+        for (int b = 0; b < batch_size; b++)
+        {
+            node_values[b] = bias + response * node_values[b];
+        }
+    }
+    // nodes are grouped by activation, so activate each group in one array pass
+    int run_start = 0;
+    for (int i = 1; i <= num_evaluated; i++)
+    {
+        if (i == num_evaluated || node_activation[i] != node_activation[run_start])
+        {
+            activate_run(node_activation[run_start], precision, &next_values[static_cast<size_t>(num_inputs + run_start) * batch_size],
+                         (i - run_start) * batch_size);
+            run_start = i;
+        }
+    }
+    std::swap(values, next_values);
+}
+
+/**
+ * @brief feeds the inputs to the network and advances it by one step
+ *
+ * @param inputs
+ * @return std::vector<float>
+ */
+std::vector<float> RecurrentNetwork::forward(const std::vector<float> &inputs)
+{
+    std::vector<float> outputs(num_outputs);
+    forward(std::span<const float>(inputs), std::span<float>(outputs));
+    return outputs;
+}
+
+/**
+ * @brief feeds the inputs to the network and advances it by one step without allocating
+ * Resets the state if it was last used for a batch of several sequences
+ *
+ * @param inputs num_inputs values
+ * @param outputs receives num_outputs values
+ */
+void RecurrentNetwork::forward(std::span<const float> inputs, std::span<float> outputs)
+{
+    if (inputs.size() != static_cast<size_t>(num_inputs))
+    {
+        throw std::invalid_argument("Incorrect number of inputs provided, given: " +
+                                    std::to_string(inputs.size()) +
+                                    ", need: " +
+                                    std::to_string(num_inputs));
+    }
+    if (outputs.size() != static_cast<size_t>(num_outputs))
+    {
+        throw std::invalid_argument("Incorrect number of outputs provided, given: " +
+                                    std::to_string(outputs.size()) +
+                                    ", need: " +
+                                    std::to_string(num_outputs));
+    }
+    if (batch_size != 1)
+    {
+        batch_size = 1;
+        reset();
+    }
+
+    std::copy(inputs.begin(), inputs.end(), values.begin());
+    step();
+    for (int o = 0; o < num_outputs; o++)
+    {
+        outputs[o] = values[output_indices[o]];
+    }
+}
+
+/**
+ * @brief advances batch_size independent sequences by one step each
+ * Sequence b keeps its own state between calls, the state is reset when batch_size changes
+ *
+ * @param inputs row-major batch_size x num_inputs matrix, row b is the next input of sequence b
+ * @param _batch_size number of sequences
+ * @return std::vector<float> row-major batch_size x num_outputs matrix
+ */
+std::vector<float> RecurrentNetwork::forward_batch(const std::vector<float> &inputs, int _batch_size)
+{
+    if (_batch_size < 1 || inputs.size() != static_cast<size_t>(_batch_size) * num_inputs)
+    {
+        throw std::invalid_argument("Incorrect number of inputs provided, given: " +
+                                    std::to_string(inputs.size()) +
+                                    ", need: " +
+                                    std::to_string(_batch_size) + " x " + std::to_string(num_inputs));
+    }
+    if (batch_size != _batch_size)
+    {
+        batch_size = _batch_size;
+        reset();
+    }
+
+    for (int b = 0; b < batch_size; b++)
+    {
+        for (int in = 0; in < num_inputs; in++)
+        {
+            values[in * batch_size + b] = inputs[b * num_inputs + in];
+        }
+    }
+    step();
+
+    std::vector<float> outputs(static_cast<size_t>(batch_size) * num_outputs);
+    for (int o = 0; o < num_outputs; o++)
+    {
+        const float *output_values = &values[output_indices[o] * batch_size];
+        for (int b = 0; b < batch_size; b++)
+        {
+            outputs[b * num_outputs + o] = output_values[b];
+        }
+    }
+    return outputs;
+}
+
+/// ------------ CTRNN ------------///
+
+/**
+ * @brief Construct a new, empty CTRNN object with every state at 0
+ *
+ * @param _num_inputs number of network inputs (dense indices [0, _num_inputs))
+ * @param _num_evaluated number of nodes that will be added with add_node
+ * @param _integrator fixed step integrator used by advance
+ * @param _precision how closely the transcendental activations are computed
+ */
+CTRNN::CTRNN(int _num_inputs, int _num_evaluated, ctrnn_integrator _integrator, valid_precisions _precision)
+{
+    num_inputs = _num_inputs;
+    num_outputs = 0;
+    num_nodes = _num_inputs + _num_evaluated;
+    integrator = _integrator;
+    precision = _precision;
+    edge_offsets = {0};
+    // derivatives of the inputs are always 0
+    k1.assign(num_nodes, 0.0F);
+    k2.assign(num_nodes, 0.0F);
+    k3.assign(num_nodes, 0.0F);
+    k4.assign(num_nodes, 0.0F);
+    reset();
+}
+
+/**
+ * @brief gets the number of nodes that are integrated (every node that is not an input)
+ *
+ * @return int
+ */
+int CTRNN::get_num_evaluated() const
+{
+    return num_nodes - num_inputs;
+}
+
+/**
+ * @brief appends the next evaluated node, edges added afterwards feed into this node
+ *
+ * @param bias
+ * @param response
+ * @param time_constant must be positive, smaller time constants react faster
+ * @param activation
+ * @param aggregation
+ * @return int dense index of the new node
+ */
+int CTRNN::add_node(float bias, float response, float time_constant, valid_activations activation, valid_aggregations aggregation)
+{
+    if (node_bias.size() >= static_cast<size_t>(get_num_evaluated()))
+    {
+        throw std::runtime_error("All " + std::to_string(get_num_evaluated()) + " nodes of the network were already added");
+    }
+    if (!(time_constant > 0.0F))
+    {
+        throw std::invalid_argument("Time constant (" + std::to_string(time_constant) + ") must be greater than 0");
+    }
+    node_bias.push_back(bias);
+    node_response.push_back(response);
+    node_time_constant.push_back(time_constant);
+    node_inv_time_constant.push_back(1.0F / time_constant);
+    node_activation.push_back(activation);
+    node_aggregation.push_back(aggregation);
+    edge_offsets.push_back(edge_offsets.back());
+    return num_inputs + static_cast<int>(node_bias.size()) - 1;
+}
+
+/**
+ * @brief adds an incoming edge to the most recently added node, the source can be any node
+ *
+ * @param source dense index of the node feeding the edge
+ * @param weight
+ */
+void CTRNN::add_edge(int source, float weight)
+{
+    if (source < 0 || source >= num_nodes || node_bias.empty())
+    {
+        throw std::invalid_argument("Edge source " + std::to_string(source) + " is not a node of the network");
+    }
+    edge_sources.push_back(source);
+    edge_weights.push_back(weight);
+    edge_offsets.back()++;
+}
+
+/**
+ * @brief marks the node at node_index as the next output of the network
+ *
+ * @param node_index
+ */
+void CTRNN::add_output(int node_index)
+{
+    output_indices.push_back(node_index);
+    num_outputs++;
+}
+
+/**
+ * @brief sets the state of every node back to 0
+ */
+void CTRNN::reset()
+{
+    state.assign(num_nodes, 0.0F);
+    stage.assign(num_nodes, 0.0F);
+}
+
+/**
+ * @brief gets the state of every node, inputs first
+ *
+ * @return std::vector<float>
+ */
+std::vector<float> CTRNN::get_state() const
+{
+    return state;
+}
+
+/**
+ * @brief computes the derivative of every evaluated node's state at state y
+ *
+ * @param y state of every node
+ * @param dydt receives the derivative of every node, the inputs are left untouched
+ */
+void CTRNN::derivative(const float *y, float *dydt)
+{
+    const int num_evaluated = get_num_evaluated();
+    float *target = dydt + num_inputs;
+    for (int i = 0; i < num_evaluated; i++)
+    {
+        const int first_edge = edge_offsets[i];
+        aggregate_batch(node_aggregation[i], edge_sources.data() + first_edge, edge_weights.data() + first_edge, edge_offsets[i + 1] - first_edge,
+                        y, 1, &target[i], agg_vec);
+        target[i] = node_bias[i] + node_response[i] * target[i];
+    }
+    // nodes are grouped by activation, so activate each group in one array pass
+    int run_start = 0;
+    for (int i = 1; i <= num_evaluated; i++)
+    {
+        if (i == num_evaluated || node_activation[i] != node_activation[run_start])
+        {
+            activate_run(node_activation[run_start], precision, &target[run_start], i - run_start);
+            run_start = i;
+        }
+    }
+    const float *node_y = y + num_inputs;
+    for (int i = 0; i < num_evaluated; i++)
+    {
+        target[i] = (target[i] - node_y[i]) * node_inv_time_constant[i];
+    }
+}
+
+/**
+ * @brief holds the inputs constant and integrates the network for steps steps of dt
+ *
+ * @param inputs
+ * @param dt
+ * @param steps
+ * @return std::vector<float> the outputs after the last step
+ */
+std::vector<float> CTRNN::advance(const std::vector<float> &inputs, float dt, int steps)
+{
+    std::vector<float> outputs(num_outputs);
+    advance(std::span<const float>(inputs), std::span<float>(outputs), dt, steps);
+    return outputs;
+}
+
+/**
+ * @brief holds the inputs constant and integrates the network for steps steps of dt, without allocating
+ *
+ * @param inputs num_inputs values
+ * @param outputs receives the num_outputs values after the last step
+ * @param dt
+ * @param steps
+ */
+void CTRNN::advance(std::span<const float> inputs, std::span<float> outputs, float dt, int steps)
+{
+    if (inputs.size() != static_cast<size_t>(num_inputs))
+    {
+        throw std::invalid_argument("Incorrect number of inputs provided, given: " +
+                                    std::to_string(inputs.size()) +
+                                    ", need: " +
+                                    std::to_string(num_inputs));
+    }
+    if (outputs.size() != static_cast<size_t>(num_outputs))
+    {
+        throw std::invalid_argument("Incorrect number of outputs provided, given: " +
+                                    std::to_string(outputs.size()) +
+                                    ", need: " +
+                                    std::to_string(num_outputs));
+    }
+    if (!(dt > 0.0F) || steps < 0)
+    {
+        throw std::invalid_argument("Time step (" + std::to_string(dt) + ") must be greater than 0 and steps (" + std::to_string(steps) + ") can't be negative");
+    }
+
+    std::copy(inputs.begin(), inputs.end(), state.begin());
+    std::copy(inputs.begin(), inputs.end(), stage.begin());
+    float *y = state.data();
+    float *s = stage.data();
+    for (int step = 0; step < steps; step++)
+    {
+        if (integrator == ctrnn_integrator::euler)
+        {
+            derivative(y, k1.data());
+            for (int n = num_inputs; n < num_nodes; n++)
+            {
+                y[n] += dt * k1[n];
+            }
+            continue;
+        }
+
+        // classic 4th order Runge-Kutta
+        const float half_dt = 0.5F * dt;
+        derivative(y, k1.data());
+        for (int n = num_inputs; n < num_nodes; n++)
+        {
+            s[n] = y[n] + half_dt * k1[n];
+        }
+        derivative(s, k2.data());
+        for (int n = num_inputs; n < num_nodes; n++)
+        {
+            s[n] = y[n] + half_dt * k2[n];
+        }
+        derivative(s, k3.data());
+        for (int n = num_inputs; n < num_nodes; n++)
+        {
+            s[n] = y[n] + dt * k3[n];
+        }
+        derivative(s, k4.data());
+        const float sixth_dt = dt / 6.0F;
+        for (int n = num_inputs; n < num_nodes; n++)
+        {
+            y[n] += sixth_dt * (k1[n] + 2.0F * (k2[n] + k3[n]) + k4[n]);
+        }
+    }
+
+    for (int o = 0; o < num_outputs; o++)
+    {
+        outputs[o] = state[output_indices[o]];
+    }
+}
@@ -11,16 +11,22 @@ PopulationConfig::PopulationConfig(ConfigParser_ptr _config)
     data = _config->get_subdata("NEAT");
 
     // Population Parameters
-    fitness_criterion = get_value<std::string>("fitness_criterion");
+    fitness_criterion = to_aggregation(get_value<std::string>("fitness_criterion"));
     fitness_threshold = get_value<float>("fitness_threshold");
     pop_size = get_value<int>("pop_size");
     reset_on_extinction = get_value<bool>("reset_on_extinction");
     no_fitness_termination = get_value<bool>("no_fitness_termination");
+    // optional, allocate every generation from one recycled arena instead of the heap
+    genome_arena = false;
+    if (has_value("genome_arena"))
+    {
+        genome_arena = get_value<bool>("genome_arena");
+    }
 
     // Configure from Parser
     data = _config->get_subdata("DefaultStagnation");
 
-    species_fitness_func = get_value<std::string>("species_fitness_func");
+    species_fitness_func = to_aggregation(get_value<std::string>("species_fitness_func"));
     max_stagnation = get_value<int>("max_stagnation");
     species_elitism = get_value<int>("species_elitism");
 
@@ -30,6 +36,8 @@ PopulationConfig::PopulationConfig(ConfigParser_ptr _config)
     elitism = get_value<int>("elitism");
     survival_threshold = get_value<float>("survival_threshold");
     min_species_size = get_value<int>("min_species_size");
+
+    genome_config = std::make_shared<GenomeConfig>(_config);
 }
 
 Population::Population(ConfigParser_ptr _config)
@@ -38,7 +46,8 @@ Population::Population(ConfigParser_ptr _config)
     config = std::make_shared<PopulationConfig>(_config);
     species_set = std::make_shared<SpeciesSet>(_config);
     total_genomes = 1;
-    population = new_population(_config, config->pop_size);
+    arenas = {};
+    population = new_population(config->genome_config, config->pop_size);
     species_set->speciate(population, 0);
 }
 
@@ -110,7 +119,7 @@ Genome_ptr Population::run(std::function<float(Genome_ptr)> fitness_function, in
         {
             if (config->reset_on_extinction)
             {
-                population = new_population(raw_config, config->pop_size);
+                population = new_population(config->genome_config, config->pop_size);
             }
             else
             {
@@ -168,12 +177,14 @@ Genome_ptr Population::run(std::function<float(Genome_ptr)> fitness_function, in
  * @param pop_size population size to generate
  * @return std::map<int, Genome_ptr>
  */
-std::map<int, Genome_ptr> Population::new_population(ConfigParser_ptr _config, int pop_size)
+std::map<int, Genome_ptr> Population::new_population(GenomeConfig_ptr _config, int pop_size)
 {
     std::map<int, Genome_ptr> pop;
+    GenomeArena_ptr arena = config->genome_arena ? next_arena() : nullptr;
     for (int i = 0; i < pop_size; i++)
     {
-        Genome_ptr g = std::make_shared<Genome>(total_genomes++, _config);
+        Genome_ptr g = arena ? make_arena_genome(arena, total_genomes++, _config)
+                             : std::make_shared<Genome>(total_genomes++, _config);
         pop[g->key] = g;
     }
     return pop;
@@ -322,6 +333,9 @@ std::map<int, int> Population::calc_spawns(std::map<int, float> adj_fitnesses, s
  */
 std::map<int, Genome_ptr> Population::reproduce(int generation)
 {
+    // Splits of this generation are new innovations, even if a previous generation made them
+    config->genome_config->innovation_tracker->next_generation();
+
     // 1. Prune Stagnant Species
     std::vector<int> stagnant_species = get_stagnant_species(generation);
 
@@ -374,6 +388,7 @@ std::map<int, Genome_ptr> Population::reproduce(int generation)
 
     // 4. Reprocuce the Current Population based on desired spawns
     std::map<int, Genome_ptr> new_population = {};
+    GenomeArena_ptr arena = config->genome_arena ? next_arena() : nullptr;
     for (std::pair<const int, int> &it : new_sizes)
     {
         const int sid = it.first;
@@ -400,7 +415,8 @@ std::map<int, Genome_ptr> Population::reproduce(int generation)
         {
             if (i < config->elitism)
             {
-                new_population[old_members[i]->key] = old_members[i];
+                // Elites are copied into the new arena so they don't keep the previous generation's arena alive
+                new_population[old_members[i]->key] = arena ? make_arena_genome(arena, *old_members[i]) : old_members[i];
             }
             else
             {
@@ -429,7 +445,8 @@ std::map<int, Genome_ptr> Population::reproduce(int generation)
                 }
 
                 int gid = total_genomes++;
-                Genome_ptr child = std::make_shared<Genome>(gid, parent1, parent2, raw_config);
+                Genome_ptr child = arena ? make_arena_genome(arena, gid, parent1, parent2, config->genome_config)
+                                         : std::make_shared<Genome>(gid, parent1, parent2, config->genome_config);
                 child->mutate();
 
                 new_population[gid] = child;
@@ -439,3 +456,35 @@ std::map<int, Genome_ptr> Population::reproduce(int generation)
 
     return new_population;
 }
+
+/**
+ * @brief Get an arena for the next generation, recycling one that no genome references anymore
+ *
+ * Every genome allocated from an arena holds a reference to it, so an arena only
+ * referenced by the population can be reset safely. Arenas kept alive by genomes
+ * outside the population (e.g. the best genome returned by run) are left untouched.
+ *
+ * @return GenomeArena_ptr empty arena
+ */
+GenomeArena_ptr Population::next_arena()
+{
+    GenomeArena_ptr recycled = nullptr;
+    for (GenomeArena_ptr &arena : arenas)
+    {
+        if (arena.use_count() == 1)
+        {
+            recycled = arena;
+            recycled->reset();
+            break;
+        }
+    }
+    // Release the other unreferenced arenas, one spare is enough to alternate between generations
+    std::erase_if(arenas, [&recycled](const GenomeArena_ptr &arena)
+                  { return arena.use_count() == 1 && arena != recycled; });
+    if (!recycled)
+    {
+        recycled = std::make_shared<GenomeArena>();
+        arenas.push_back(recycled);
+    }
+    return recycled;
+}
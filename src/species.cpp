@@ -1,6 +1,7 @@
 #include "species.h"
 #include <set>
 #include <iostream>
+#include <algorithm>
 SpeciesSetConfig::SpeciesSetConfig(ConfigParser_ptr _config)
 {
     // Configure from Parser
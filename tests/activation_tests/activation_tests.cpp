@@ -0,0 +1,243 @@
+#include "activations.h"
+#include "activation_kernels.h"
+#include <gtest/gtest.h>
+#include <vector>
+#include <cmath>
+#include <chrono>
+#include <limits>
+#include <algorithm>
+
+std::vector<simd_level> all_levels = {simd_level::scalar, simd_level::sse, simd_level::avx2, simd_level::avx512};
+
+/**
+ * @brief evenly spaced values in [low, high], odd length so every kernel has a tail to pad
+ */
+std::vector<float> sample_range(float low, float high, int n = 1001)
+{
+    std::vector<float> values(n);
+    for (int i = 0; i < n; i++)
+    {
+        values[i] = low + (high - low) * static_cast<float>(i) / static_cast<float>(n - 1);
+    }
+    return values;
+}
+
+/**
+ * @brief checks the kernels for every supported level against activate_value
+ */
+void expect_matches_scalar(valid_activations method, const std::vector<float> &inputs, valid_precisions precision = valid_precisions::exact)
+{
+    for (simd_level level : all_levels)
+    {
+        if (!simd_level_supported(level))
+        {
+            continue;
+        }
+        std::vector<float> values = inputs;
+        activate_array(method, precision, values.data(), values.size(), level);
+        for (size_t i = 0; i < inputs.size(); i++)
+        {
+            const float expected = activate_value(inputs[i], method, precision);
+            if (std::isinf(expected))
+            {
+                EXPECT_EQ(values[i], expected) << "level " << static_cast<int>(level) << " x = " << inputs[i];
+            }
+            else
+            {
+                EXPECT_NEAR(values[i], expected, 1e-5F * std::fabs(expected) + 1e-6F) << "level " << static_cast<int>(level) << " x = " << inputs[i];
+            }
+        }
+    }
+}
+
+TEST(ACTIVATIONS, StringMethodTest){
+    ASSERT_EQ(activate_value(2.0F, "relu"), 2.0F);
+    ASSERT_EQ(activate_value(-2.0F, "relu"), 0.0F);
+    ASSERT_THROW(activate_value(0.0F, "asdf"), std::invalid_argument);
+}
+
+TEST(ACTIVATIONS, ScalarAlwaysSupportedTest){
+    ASSERT_TRUE(simd_level_supported(simd_level::scalar));
+    ASSERT_TRUE(simd_level_supported(get_simd_level()));
+}
+
+TEST(ACTIVATIONS, UnsupportedLevelTest){
+    float value = 0.0F;
+    for (simd_level level : all_levels)
+    {
+        if (!simd_level_supported(level))
+        {
+            ASSERT_THROW(activate_array(sigmoid_act, &value, 1, level), std::invalid_argument);
+        }
+    }
+}
+
+TEST(ACTIVATIONS, SigmoidKernelTest){
+    expect_matches_scalar(sigmoid_act, sample_range(-100, 100));
+}
+
+TEST(ACTIVATIONS, TanhKernelTest){
+    expect_matches_scalar(tanh_act, sample_range(-20, 20));
+    expect_matches_scalar(tanh_act, sample_range(-1, 1));
+}
+
+TEST(ACTIVATIONS, SinKernelTest){
+    expect_matches_scalar(sin_act, sample_range(-50, 50));
+    expect_matches_scalar(sin_act, sample_range(-8192, 8192, 100001));
+    // beyond the range reduction of the kernels lanes fall back to std::sin
+    expect_matches_scalar(sin_act, sample_range(1e4F, 1e7F, 10001));
+    expect_matches_scalar(sin_act, {1e4F, -3e5F, 0.5F, 1e30F, -2.0F, 8192.5F, -1e9F});
+}
+
+TEST(ACTIVATIONS, NanKernelTest){
+    // every kernel keeps NaN like the scalar activations do, relu is the only one mapping it to 0
+    for (simd_level level : all_levels)
+    {
+        if (!simd_level_supported(level))
+        {
+            continue;
+        }
+        for (valid_activations method : {sigmoid_act, tanh_act, sin_act, gauss_act, softplus_act, clamped_act, abs_act, square_act, cubed_act, relu_act})
+        {
+            std::vector<float> values(21, 0.5F);
+            values[3] = std::nanf("");
+            values[20] = std::nanf("");
+            activate_array(method, values.data(), values.size(), level);
+            EXPECT_EQ(std::isnan(values[3]), std::isnan(activate_value(std::nanf(""), method))) << "level " << static_cast<int>(level) << " method " << method;
+            EXPECT_EQ(std::isnan(values[20]), std::isnan(activate_value(std::nanf(""), method))) << "level " << static_cast<int>(level) << " method " << method;
+            EXPECT_FALSE(std::isnan(values[4]));
+        }
+    }
+}
+
+TEST(ACTIVATIONS, GaussKernelTest){
+    expect_matches_scalar(gauss_act, sample_range(-9, 9));
+    expect_matches_scalar(gauss_act, {10.0F, -12.0F});
+}
+
+TEST(ACTIVATIONS, SoftplusKernelTest){
+    expect_matches_scalar(softplus_act, sample_range(-80, 80));
+    // the scalar version overflows to inf here, the kernel keeps returning x
+    std::vector<float> values = {100.0F, 1000.0F};
+    activate_array(softplus_act, values.data(), values.size());
+    ASSERT_EQ(values[0], 100.0F);
+    ASSERT_EQ(values[1], 1000.0F);
+}
+
+TEST(ACTIVATIONS, PiecewiseKernelTest){
+    const std::vector<float> inputs = sample_range(-10, 10);
+    expect_matches_scalar(linear_act, inputs);
+    expect_matches_scalar(relu_act, inputs);
+    expect_matches_scalar(clamped_act, inputs);
+    expect_matches_scalar(abs_act, inputs);
+    expect_matches_scalar(square_act, inputs);
+    expect_matches_scalar(cubed_act, inputs);
+}
+
+TEST(ACTIVATIONS, ShortArrayTest){
+    // arrays shorter than one vector only go through the padded tail
+    for (size_t n = 0; n < 20; n++)
+    {
+        expect_matches_scalar(sigmoid_act, sample_range(-3, 3, n + 2));
+    }
+}
+
+/**
+ * @brief checks the approximation stays within the documented bound of the exact activation
+ */
+void expect_within_bound(valid_activations method, valid_precisions precision, float low, float high, double bound, bool relative)
+{
+    for (float x : sample_range(low, high, 200001))
+    {
+        const double expected = activate_value(x, method);
+        const double error = std::fabs(activate_value(x, method, precision) - expected);
+        EXPECT_LE(relative ? error / expected : error, bound) << "x = " << x;
+    }
+}
+
+TEST(ACTIVATIONS, PrecisionStringTest){
+    ASSERT_EQ(to_precision("exact"), valid_precisions::exact);
+    ASSERT_EQ(to_precision("fast"), valid_precisions::fast);
+    ASSERT_EQ(to_precision("lut"), valid_precisions::lut);
+    ASSERT_THROW(to_precision("asdf"), std::invalid_argument);
+}
+
+TEST(ACTIVATIONS, FastErrorBoundTest){
+    expect_within_bound(sigmoid_act, valid_precisions::fast, -100, 100, 1e-6, false);
+    expect_within_bound(tanh_act, valid_precisions::fast, -20, 20, 2e-6, false);
+    expect_within_bound(softplus_act, valid_precisions::fast, -80, 80, 1e-5, false);
+    expect_within_bound(gauss_act, valid_precisions::fast, -9, 9, 2e-5, true);
+    for (valid_activations method : {sigmoid_act, tanh_act, softplus_act, gauss_act})
+    {
+        EXPECT_TRUE(std::isnan(activate_value(std::nanf(""), method, valid_precisions::fast))) << "method " << method;
+    }
+}
+
+TEST(ACTIVATIONS, LutErrorBoundTest){
+    expect_within_bound(sigmoid_act, valid_precisions::lut, -100, 100, 5e-6, false);
+    expect_within_bound(tanh_act, valid_precisions::lut, -20, 20, 1e-5, false);
+    expect_within_bound(softplus_act, valid_precisions::lut, -80, 80, 1e-5, false);
+    expect_within_bound(gauss_act, valid_precisions::lut, -9, 9, 2e-5, true);
+    for (valid_activations method : {sigmoid_act, tanh_act, softplus_act, gauss_act})
+    {
+        EXPECT_TRUE(std::isnan(activate_value(std::nanf(""), method, valid_precisions::lut))) << "method " << method;
+    }
+}
+
+TEST(ACTIVATIONS, FastKernelTest){
+    expect_matches_scalar(sigmoid_act, sample_range(-100, 100), valid_precisions::fast);
+    expect_matches_scalar(tanh_act, sample_range(-20, 20), valid_precisions::fast);
+    expect_matches_scalar(softplus_act, sample_range(-80, 80), valid_precisions::fast);
+    expect_matches_scalar(gauss_act, sample_range(-9.4F, 9.4F), valid_precisions::fast);
+    expect_matches_scalar(relu_act, sample_range(-10, 10), valid_precisions::fast);
+}
+
+TEST(ACTIVATIONS, LutKernelTest){
+    expect_matches_scalar(sigmoid_act, sample_range(-100, 100), valid_precisions::lut);
+    expect_matches_scalar(sigmoid_act, {-16.0F, 16.0F, 15.99F}, valid_precisions::lut);
+    expect_matches_scalar(tanh_act, sample_range(-20, 20), valid_precisions::lut);
+    expect_matches_scalar(softplus_act, sample_range(-80, 80), valid_precisions::lut);
+    expect_matches_scalar(gauss_act, sample_range(-9.4F, 9.4F), valid_precisions::lut);
+    expect_matches_scalar(sin_act, sample_range(-10, 10), valid_precisions::lut);
+}
+
+/**
+ * @brief best time in microseconds of applying the activation to values over several runs
+ */
+double time_kernel(valid_activations method, valid_precisions precision, const std::vector<float> &inputs)
+{
+    double best = std::numeric_limits<double>::infinity();
+    std::vector<float> values(inputs.size());
+    for (int run = 0; run < 20; run++)
+    {
+        std::copy(inputs.begin(), inputs.end(), values.begin());
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        activate_array(method, precision, values.data(), values.size());
+        best = std::min(best, std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+TEST(ACTIVATIONS, FastKernelSpeedTest){
+    // fast precision has to pay off against the exact kernels of the same instruction set,
+    // tanh and softplus are the activations where exact needs the most work
+    const std::vector<float> inputs = sample_range(-8, 8, 1 << 16);
+    const double exact_time = time_kernel(tanh_act, valid_precisions::exact, inputs) + time_kernel(softplus_act, valid_precisions::exact, inputs);
+    const double fast_time = time_kernel(tanh_act, valid_precisions::fast, inputs) + time_kernel(softplus_act, valid_precisions::fast, inputs);
+    ASSERT_LT(fast_time, exact_time);
+}
+
+TEST(ACTIVATIONS, ExactPrecisionTest){
+    // only the transcendental activations are approximated
+    for (float x : sample_range(-5, 5, 101))
+    {
+        ASSERT_EQ(activate_value(x, sigmoid_act, valid_precisions::exact), activate_value(x, sigmoid_act));
+        ASSERT_EQ(activate_value(x, relu_act, valid_precisions::fast), activate_value(x, relu_act));
+        ASSERT_EQ(activate_value(x, sin_act, valid_precisions::lut), activate_value(x, sin_act));
+    }
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -38,6 +38,37 @@ TEST(AGGREGATIONS, MedianTest){
     ASSERT_EQ(aggregate_vector(sample_vector3, "median"), -2);
 }
 
+TEST(AGGREGATIONS, EmptyTest){
+    std::vector<float> empty_vector = {};
+    ASSERT_EQ(aggregate_vector(empty_vector, "sum"), 0);
+    ASSERT_EQ(aggregate_vector(empty_vector, "mean"), 0);
+    ASSERT_EQ(aggregate_vector(empty_vector, "max"), 0);
+    ASSERT_EQ(aggregate_vector(empty_vector, "min"), 0);
+    ASSERT_EQ(aggregate_vector(empty_vector, "median"), 0);
+}
+
+TEST(AGGREGATIONS, FoldTest){
+    for (std::pair<const std::string, valid_aggregations> &agg : agg_map)
+    {
+        if (!is_streamable(agg.second))
+        {
+            continue;
+        }
+        float acc = aggregate_identity(agg.second);
+        for (float value : sample_vector3)
+        {
+            acc = aggregate_fold(agg.second, acc, value);
+        }
+        ASSERT_EQ(aggregate_finish(agg.second, acc, sample_vector3.size()), aggregate_vector(sample_vector3, agg.first));
+    }
+}
+
+TEST(AGGREGATIONS, MedianKeepsInputTest){
+    std::vector<float> unsorted = {3, 1, 2};
+    ASSERT_EQ(aggregate_vector(unsorted, valid_aggregations::median), 2);
+    ASSERT_EQ(unsorted[0], 3);
+}
+
 int main(int argc, char **argv) {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
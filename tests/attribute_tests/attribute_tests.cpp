@@ -1,4 +1,9 @@
 #include "attributes.h"
+#include "random_generator.h"
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
 #include <gtest/gtest.h>
 
 // FLOAT ATTRIBUTE
@@ -32,6 +37,111 @@ TEST(FLOATATTR, ConvTest)
   ASSERT_TRUE(test.get_float_value() == static_cast<float>(test.get_float_value()));
 }
 
+TEST(FLOATATTR, SpecTest)
+{
+  ASSERT_THROW(AttributeSpec(float_attribute, "bad_attr", 0.0F, 1.0F, "triangle", 0.5F, 1.0F, -10.F, 10.F), std::invalid_argument);
+  AttributeSpec_ptr spec = std::make_shared<AttributeSpec>(float_attribute, "bias", 0.0F, 5.0F, "gauss", 1.0F, 1.0F, -10.F, 10.F);
+
+  // Attributes created from a spec only store their value
+  std::vector<FloatAttribute> attributes;
+  for (int i = 0; i < 100; i++)
+  {
+    attributes.emplace_back(spec);
+    ASSERT_EQ(attributes.back().spec, spec);
+    ASSERT_TRUE(attributes.back().value <= 10.F && attributes.back().value >= -10.F);
+  }
+  ASSERT_EQ(attributes[0].get_name(), "bias");
+
+  FloatAttribute_ptr copy = std::dynamic_pointer_cast<FloatAttribute>(attributes[0].copy());
+  ASSERT_EQ(copy->spec, spec);
+  ASSERT_EQ(copy->value, attributes[0].value);
+
+  float mutated = spec->mutate_float(10.F);
+  ASSERT_TRUE(mutated <= 10.F && mutated >= -10.F);
+}
+
+TEST(FLOATATTR, MutateFloatsTest)
+{
+  // half of the values are perturbed by a standard gaussian
+  AttributeSpec spec(float_attribute, "weight", 0.0F, 1.0F, "gaussian", 0.5F, 1.0F, -30.F, 30.F);
+  std::vector<float> values(10000, 0.0F);
+  spec.mutate_floats(values);
+  int mutated = 0;
+  float sum = 0.0F;
+  float square_sum = 0.0F;
+  for (float value : values)
+  {
+    if (value != 0.0F)
+    {
+      mutated++;
+      sum += value;
+      square_sum += value * value;
+    }
+  }
+  ASSERT_NEAR(mutated / 10000.0F, 0.5F, 0.03F);
+  ASSERT_NEAR(sum / mutated, 0.0F, 0.1F);
+  ASSERT_NEAR(std::sqrt(square_sum / mutated), 1.0F, 0.1F);
+
+  // mutated values stay in bounds and a rate of 0 leaves them alone
+  AttributeSpec narrow(float_attribute, "bias", 0.0F, 1.0F, "gaussian", 1.0F, 10.0F, -0.5F, 0.5F);
+  narrow.mutate_floats(values);
+  ASSERT_TRUE(std::all_of(values.begin(), values.end(), [](float value)
+                          { return value >= -0.5F && value <= 0.5F; }));
+  std::vector<float> before = values;
+  AttributeSpec fixed(float_attribute, "time_constant", 1.0F, 0.0F, "gaussian", 0.0F, 1.0F, -30.F, 30.F);
+  fixed.mutate_floats(values);
+  ASSERT_EQ(values, before);
+}
+
+TEST(FLOATATTR, SparseMutateFloatsTest)
+{
+  // low rates only visit the values they mutate, with the same distribution
+  AttributeSpec spec(float_attribute, "weight", 0.0F, 1.0F, "gaussian", 0.05F, 1.0F, -30.F, 30.F);
+  std::vector<float> values(20000, 0.0F);
+  spec.mutate_floats(values);
+  int mutated = 0;
+  float square_sum = 0.0F;
+  for (float value : values)
+  {
+    if (value != 0.0F)
+    {
+      mutated++;
+      square_sum += value * value;
+    }
+  }
+  ASSERT_NEAR(mutated / 20000.0F, 0.05F, 0.005F);
+  ASSERT_NEAR(std::sqrt(square_sum / mutated), 1.0F, 0.1F);
+}
+
+TEST(RANDOM, BernoulliTest)
+{
+  // every index succeeds with the rate, in increasing order
+  const size_t count = 100000;
+  std::vector<size_t> hits;
+  for_each_bernoulli(count, 0.01F, [&hits](size_t i)
+                     { hits.push_back(i); });
+  ASSERT_NEAR(hits.size(), 1000, 150);
+  ASSERT_TRUE(std::is_sorted(hits.begin(), hits.end()));
+  ASSERT_TRUE(std::adjacent_find(hits.begin(), hits.end()) == hits.end());
+  ASSERT_LT(hits.back(), count);
+
+  // successes are spread evenly over the indices
+  size_t first_half = std::count_if(hits.begin(), hits.end(), [count](size_t i)
+                                    { return i < count / 2; });
+  ASSERT_NEAR(first_half, hits.size() / 2, 100);
+
+  size_t num_hits = 0;
+  for_each_bernoulli(count, 0.0F, [&num_hits](size_t)
+                     { num_hits++; });
+  ASSERT_EQ(num_hits, 0);
+  for_each_bernoulli(10, 1.0F, [&num_hits](size_t)
+                     { num_hits++; });
+  ASSERT_EQ(num_hits, 10);
+  for_each_bernoulli(0, 0.5F, [&num_hits](size_t)
+                     { num_hits++; });
+  ASSERT_EQ(num_hits, 10);
+}
+
 // INT ATTRIBUTES
 TEST(INTATTR, ConstructionTest)
 {
@@ -119,7 +229,7 @@ TEST(STRATTR, MutateTest)
   for (int i = 0; i < 10; i++)
   {
     str_attr->mutate_value();
-    ASSERT_TRUE(str_options.count(str_attr->value) > 0);
+    ASSERT_TRUE(str_options.count(str_attr->get_string_value()) > 0);
   }
 }
 
@@ -134,11 +244,46 @@ TEST(STRATTR, CopyTest)
   StringAttribute_ptr str_attr = std::make_shared<StringAttribute>("test1", 1.0, str_options);
   StringAttribute_ptr str_attr2 = std::dynamic_pointer_cast<StringAttribute>(str_attr->copy());
 
-  ASSERT_EQ(str_attr->value, str_attr2->value);
+  ASSERT_EQ(str_attr->value_id, str_attr2->value_id);
+  ASSERT_TRUE(str_attr->same_value(*str_attr2));
+  ASSERT_EQ(str_attr->get_string_value(), str_attr2->get_string_value());
   ASSERT_EQ(str_attr->get_mutate_rate(), str_attr2->get_mutate_rate());
+  // copies share the options instead of duplicating them
   ASSERT_EQ(str_attr->get_options(), str_attr2->get_options());
 }
 
+TEST(STRATTR, InternTest)
+{
+  std::set<std::string> str_options = {"option2", "option1", "option3"};
+
+  // Attributes created from equal options share one OptionSet
+  StringAttribute str_attr1("test1", 1.0, str_options);
+  StringAttribute str_attr2("test2", 0.5, std::set<std::string>{"option1", "option2", "option3"});
+  ASSERT_EQ(str_attr1.get_options(), str_attr2.get_options());
+  ASSERT_EQ(str_attr1.get_options(), OptionSet::intern(str_options));
+  ASSERT_NE(str_attr1.get_options(), OptionSet::intern({"option1"}));
+
+  OptionSet_ptr options = str_attr1.get_options();
+  ASSERT_EQ(options->size(), 3);
+  ASSERT_EQ(options->at(options->id("option2")), "option2");
+  ASSERT_EQ(options->id("option4"), -1);
+
+  // Values are compared by their index
+  AttributeSpec_ptr spec = str_attr1.spec;
+  StringAttribute str_attr3(spec, options->id("option3"));
+  StringAttribute str_attr4(spec, options->id("option3"));
+  ASSERT_TRUE(str_attr3.same_value(str_attr4));
+  ASSERT_EQ(str_attr3.get_string_value(), "option3");
+  str_attr4.value_id = options->id("option1");
+  ASSERT_FALSE(str_attr3.same_value(str_attr4));
+
+  // Values of different option sets are compared by their string
+  StringAttribute str_attr5("test5", 1.0, std::set<std::string>{"option3"});
+  ASSERT_TRUE(str_attr3.same_value(str_attr5));
+
+  ASSERT_THROW(StringAttribute(spec, 3), std::invalid_argument);
+}
+
 TEST(STRATTR, ConvTest)
 {
   std::set<std::string> str_options1;
@@ -158,8 +303,8 @@ TEST(STRATTR, ConvTest)
   ASSERT_TRUE(test1.get_float_value() == 0);
   ASSERT_TRUE(test2.get_float_value() == 11);
   ASSERT_TRUE(test3.get_float_value() == 0);
-  ASSERT_TRUE(test1.get_string_value() == test1.value);
-  ASSERT_TRUE(test2.get_string_value() == test2.value);
+  ASSERT_TRUE(test1.get_string_value() == "");
+  ASSERT_TRUE(test2.get_string_value() == "11");
 }
 
 int main(int argc, char **argv)
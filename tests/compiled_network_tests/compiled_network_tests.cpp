@@ -0,0 +1,193 @@
+#include "compiled_network.h"
+#include "network.h"
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <thread>
+#include <cstdlib>
+#include <unistd.h>
+
+std::string test_cache_dir = (std::filesystem::temp_directory_path() / "neat-cpp-test-cache").string();
+
+/**
+ * @brief two inputs, a level of hidden nodes using every aggregation and two outputs
+ */
+FeedForwardNetwork build_network()
+{
+    FeedForwardNetwork network(2);
+    network.add_level();
+    network.add_node(0.5F, 1.0F, sigmoid_act, valid_aggregations::sum);
+    network.add_edge(0, 0.3F);
+    network.add_edge(1, -1.7F);
+    network.add_node(-0.25F, 2.0F, tanh_act, valid_aggregations::mean);
+    network.add_edge(0, 1.1F);
+    network.add_edge(1, 0.9F);
+    network.add_node(0.0F, 1.0F, relu_act, valid_aggregations::max);
+    network.add_edge(0, -2.0F);
+    network.add_edge(1, 0.5F);
+    network.add_node(0.1F, 0.5F, gauss_act, valid_aggregations::min);
+    network.add_edge(0, 0.2F);
+    network.add_edge(1, -0.4F);
+    network.add_node(1.0F, 1.0F, softplus_act, valid_aggregations::sum);
+
+    network.add_level();
+    network.add_node(0.2F, 1.5F, sin_act, valid_aggregations::median);
+    network.add_edge(2, 1.0F);
+    network.add_edge(3, -0.5F);
+    network.add_edge(4, 0.75F);
+    network.add_node(0.0F, 1.0F, clamped_act, valid_aggregations::sum);
+    network.add_edge(5, 0.6F);
+    network.add_edge(6, 0.1F);
+    network.add_edge(0, 1.3F);
+    network.add_output(7);
+    network.add_output(8);
+    return network;
+}
+
+TEST(COMPILEDNETWORK, SourceTest)
+{
+    std::string source = CompiledNetwork::generate_source(build_network());
+    ASSERT_NE(source.find("extern \"C\" void neat_forward"), std::string::npos);
+    ASSERT_NE(source.find("median_agg(m5, 3)"), std::string::npos);
+    // the same network always generates the same source
+    ASSERT_EQ(source, CompiledNetwork::generate_source(build_network()));
+}
+
+TEST(COMPILEDNETWORK, ForwardMatchesNetworkTest)
+{
+    FeedForwardNetwork network = build_network();
+    CompiledNetwork compiled(network, test_cache_dir, CompiledNetwork::default_compiler());
+    ASSERT_EQ(compiled.get_num_inputs(), 2);
+    ASSERT_EQ(compiled.get_num_outputs(), 2);
+
+    for (float x = -2.0F; x <= 2.0F; x += 0.25F)
+    {
+        std::vector<float> expected = network.forward({x, 1.0F - x});
+        std::vector<float> out = compiled.forward({x, 1.0F - x});
+        ASSERT_EQ(out.size(), expected.size());
+        for (size_t o = 0; o < out.size(); o++)
+        {
+            ASSERT_NEAR(out[o], expected[o], 1e-5F);
+        }
+    }
+    ASSERT_THROW(compiled.forward({1.0F}), std::invalid_argument);
+}
+
+TEST(COMPILEDNETWORK, CacheTest)
+{
+    FeedForwardNetwork network = build_network();
+    std::string path;
+    {
+        CompiledNetwork compiled(network, test_cache_dir, CompiledNetwork::default_compiler());
+        path = compiled.get_library_path();
+    }
+    ASSERT_TRUE(std::filesystem::exists(path));
+    std::filesystem::file_time_type built = std::filesystem::last_write_time(path);
+
+    // the cached library is loaded without compiling again
+    CompiledNetwork cached(network, test_cache_dir, CompiledNetwork::default_compiler());
+    ASSERT_EQ(cached.get_library_path(), path);
+    ASSERT_EQ(std::filesystem::last_write_time(path), built);
+
+    // another compiler is part of the key, so it doesn't load the cached library
+    ASSERT_THROW(CompiledNetwork(network, test_cache_dir, "no-such-compiler"), std::runtime_error);
+
+    // a different network is compiled separately
+    network.edge_weights[0] = 0.31F;
+    CompiledNetwork other(network, test_cache_dir, CompiledNetwork::default_compiler());
+    ASSERT_NE(other.get_library_path(), path);
+}
+
+TEST(COMPILEDNETWORK, CompileFailureTest)
+{
+    FeedForwardNetwork network = build_network();
+    network.node_bias[0] = 0.123F;
+    ASSERT_THROW(CompiledNetwork(network, test_cache_dir, "false"), std::runtime_error);
+}
+
+TEST(COMPILEDNETWORK, ConcurrentCompileTest)
+{
+    // threads building the same uncached network each write their own temporary files
+    FeedForwardNetwork network = build_network();
+    network.node_bias[1] = 0.321F;
+    std::vector<std::string> paths(4);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < paths.size(); t++)
+    {
+        threads.emplace_back([&network, &paths, t]()
+                             { paths[t] = CompiledNetwork(network, test_cache_dir, CompiledNetwork::default_compiler()).get_library_path(); });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+    for (const std::string &path : paths)
+    {
+        ASSERT_EQ(path, paths[0]);
+    }
+}
+
+TEST(COMPILEDNETWORK, QuotedPathTest)
+{
+    // the compiler runs without a shell, so paths need no quoting
+    FeedForwardNetwork network = build_network();
+    const std::string cache_dir = (std::filesystem::path(test_cache_dir) / "it's a \"dir\" $HOME").string();
+    CompiledNetwork compiled(network, cache_dir, CompiledNetwork::default_compiler());
+    ASSERT_TRUE(std::filesystem::exists(compiled.get_library_path()));
+    ASSERT_NEAR(compiled.forward({0.5F, 0.5F})[0], network.forward({0.5F, 0.5F})[0], 1e-5F);
+}
+
+TEST(COMPILEDNETWORK, DefaultCacheDirTest)
+{
+    // the default cache is private to the user instead of in the shared temporary directory
+    unsetenv("NEAT_CACHE_DIR");
+    setenv("XDG_CACHE_HOME", "/home/someone/.xdg-cache", 1);
+    ASSERT_EQ(CompiledNetwork::default_cache_dir(), "/home/someone/.xdg-cache/neat-cpp");
+    unsetenv("XDG_CACHE_HOME");
+    setenv("HOME", "/home/someone", 1);
+    ASSERT_EQ(CompiledNetwork::default_cache_dir(), "/home/someone/.cache/neat-cpp");
+    setenv("NEAT_CACHE_DIR", test_cache_dir.c_str(), 1);
+    ASSERT_EQ(CompiledNetwork::default_cache_dir(), test_cache_dir);
+}
+
+TEST(COMPILEDNETWORK, UntrustedCacheTest)
+{
+    FeedForwardNetwork network = build_network();
+    network.node_bias[2] = 0.456F;
+    const std::filesystem::path cache_dir = std::filesystem::path(test_cache_dir) / "private";
+    const std::string path = CompiledNetwork(network, cache_dir.string(), CompiledNetwork::default_compiler()).get_library_path();
+    ASSERT_EQ(std::filesystem::status(cache_dir).permissions() & std::filesystem::perms::all, std::filesystem::perms::owner_all);
+
+    // a library or cache directory others can write to could have been planted, so it is never loaded
+    const std::filesystem::perms others_write = std::filesystem::perms::group_write | std::filesystem::perms::others_write;
+    std::filesystem::permissions(path, others_write, std::filesystem::perm_options::add);
+    ASSERT_THROW(CompiledNetwork(network, cache_dir.string(), CompiledNetwork::default_compiler()), std::runtime_error);
+    std::filesystem::permissions(path, others_write, std::filesystem::perm_options::remove);
+    ASSERT_NO_THROW(CompiledNetwork(network, cache_dir.string(), CompiledNetwork::default_compiler()));
+
+    std::filesystem::permissions(cache_dir, others_write, std::filesystem::perm_options::add);
+    ASSERT_THROW(CompiledNetwork(network, cache_dir.string(), CompiledNetwork::default_compiler()), std::runtime_error);
+    std::filesystem::permissions(cache_dir, others_write, std::filesystem::perm_options::remove);
+
+    // neither is a library linked to from a file the current user doesn't own
+    const std::string planted = path + ".planted";
+    std::filesystem::rename(path, planted);
+    std::filesystem::create_symlink(planted, path);
+    ASSERT_THROW(CompiledNetwork(network, cache_dir.string(), CompiledNetwork::default_compiler()), std::runtime_error);
+    std::filesystem::remove(path);
+    std::filesystem::rename(planted, path);
+
+    // nor a library owned by another user, only root can give a file away
+    if (geteuid() != 0)
+    {
+        GTEST_SKIP() << "Planting a library owned by another user needs root";
+    }
+    ASSERT_EQ(chown(path.c_str(), 65534, 65534), 0);
+    ASSERT_THROW(CompiledNetwork(network, cache_dir.string(), CompiledNetwork::default_compiler()), std::runtime_error);
+}
+
+int main(int argc, char **argv) {
+  testing::InitGoogleTest(&argc, argv);
+  int result = RUN_ALL_TESTS();
+  std::filesystem::remove_all(test_cache_dir);
+  return result;
+}
@@ -1,178 +1,138 @@
 #include "genes.h"
-#include "attributes.h"
+#include "genome.h"
+#include "config_parser.h"
 
-#include <vector>
+#include <type_traits>
 #include <gtest/gtest.h>
 
-NodeGene_ptr create_Node1()
+// genes are plain values that own no memory
+static_assert(std::is_trivially_destructible_v<NodeGene>);
+
+NodeGene create_Node1()
 {
-  FloatAttribute_ptr bias1 = std::make_shared<FloatAttribute>("bias", 1.F, 0.1F, "gauss", 0.5F, 3.0F, 1.F, 1.F);
-  FloatAttribute_ptr resp1 = std::make_shared<FloatAttribute>("response", 2.F, 0.1F, "gauss", 0.5F, 3.0F, 2.F, 2.F);
-  std::set<std::string> act_options;
-  act_options.insert("relu");
-  StringAttribute_ptr act1 = std::make_shared<StringAttribute>("activation", 0.5F, act_options);
-  std::set<std::string> agr_options;
-  agr_options.insert("sum");
-  StringAttribute_ptr agr1 = std::make_shared<StringAttribute>("aggregation", 0.5F, agr_options);
-  BoolAttribute_ptr other1 = std::make_shared<BoolAttribute>("other", 0.5F);
-  std::vector<Attribute_ptr> gene1_attributes;
-  gene1_attributes.push_back(bias1);
-  gene1_attributes.push_back(resp1);
-  gene1_attributes.push_back(act1);
-  gene1_attributes.push_back(agr1);
-  gene1_attributes.push_back(other1);
-  NodeGene_ptr gene1 = std::make_shared<NodeGene>(1, gene1_attributes);
-  return gene1;
+  return NodeGene(1, 1.F, 2.F, relu_act, valid_aggregations::sum);
 }
 
-NodeGene_ptr create_Node2()
+NodeGene create_Node2()
 {
-  FloatAttribute_ptr bias2 = std::make_shared<FloatAttribute>("bias", 10.F, 0.1F, "gauss", 0.5F, 3.0F, 10.F, 10.F);
-  FloatAttribute_ptr resp2 = std::make_shared<FloatAttribute>("response", 20.F, 0.1F, "gauss", 0.5F, 3.0F, 20.F, 20.F);
-  std::set<std::string> act_options;
-  act_options.insert("linear");
-  StringAttribute_ptr act2 = std::make_shared<StringAttribute>("activation", 0.5F, act_options);
-  std::set<std::string> agr_options;
-  agr_options.insert("max");
-  StringAttribute_ptr agr2 = std::make_shared<StringAttribute>("aggregation", 0.5F, agr_options);
-  std::vector<Attribute_ptr> gene2_attributes;
-  gene2_attributes.push_back(bias2);
-  gene2_attributes.push_back(resp2);
-  gene2_attributes.push_back(act2);
-  gene2_attributes.push_back(agr2);
-  NodeGene_ptr gene2 = std::make_shared<NodeGene>(1, gene2_attributes);
-  return gene2;
+  return NodeGene(1, 10.F, 20.F, linear_act, valid_aggregations::max);
 }
 
-NodeGene_ptr create_MutableNode3()
+GenomeConfig_ptr create_Config()
 {
-  FloatAttribute_ptr bias2 = std::make_shared<FloatAttribute>("bias", 0.F, 10.F, "gauss", 0.5F, 3.0F, -10.F, 10.F);
-  FloatAttribute_ptr resp2 = std::make_shared<FloatAttribute>("response", 0.F, 5.F, "gauss", 0.5F, 3.0F, -20.F, 20.F);
-  std::set<std::string> act_options;
-  act_options.insert("relu");
-  act_options.insert("linear");
-  StringAttribute_ptr act2 = std::make_shared<StringAttribute>("activation", 1.0F, act_options);
-  std::set<std::string> agr_options;
-  agr_options.insert("max");
-  agr_options.insert("sum");
-  StringAttribute_ptr agr2 = std::make_shared<StringAttribute>("aggregation", 1.0F, agr_options);
-  std::vector<Attribute_ptr> gene2_attributes;
-  gene2_attributes.push_back(bias2);
-  gene2_attributes.push_back(resp2);
-  gene2_attributes.push_back(act2);
-  gene2_attributes.push_back(agr2);
-  NodeGene_ptr gene2 = std::make_shared<NodeGene>(1, gene2_attributes);
-  return gene2;
+  ConfigParser_ptr config = std::make_shared<ConfigParser>("config/GeneConfig.cfg");
+  return std::make_shared<GenomeConfig>(config);
 }
 
-TEST(GENE, HasAttributeTest)
+TEST(NODEGENE, ValueTest)
 {
-  // Create New Gene
-  Gene_ptr gene1 = create_Node1();
-
-  // Check has_attribute returns true for all attributes the gene has and false for all others
-  ASSERT_TRUE(gene1->has_attribute("bias"));
-  ASSERT_TRUE(gene1->has_attribute("response"));
-  ASSERT_TRUE(gene1->has_attribute("activation"));
-  ASSERT_TRUE(gene1->has_attribute("aggregation"));
-  ASSERT_TRUE(gene1->has_attribute("other"));
-  ASSERT_FALSE(gene1->has_attribute("notbias"));
+  NodeGene gene1 = create_Node1();
+
+  ASSERT_EQ(gene1.key, 1);
+  ASSERT_EQ(gene1.bias, 1.F);
+  ASSERT_EQ(gene1.response, 2.F);
+  ASSERT_EQ(gene1.activation, relu_act);
+  ASSERT_EQ(gene1.aggregation, valid_aggregations::sum);
+  ASSERT_EQ(gene1.time_constant, 1.F);
 }
 
-TEST(GENE, GetAttributeTest)
+TEST(NODEGENE, ConfigInitTest)
 {
-  // Create New Gene
-  Gene_ptr gene1 = create_Node1();
-
-  // Check has_attribute returns true for all attributes the gene has and false for all others
-  ASSERT_EQ(gene1->get_attribute("bias")->get_float_value(), 1.F);
-  ASSERT_EQ(gene1->get_attribute("response")->get_float_value(), 2);
-  ASSERT_TRUE(gene1->get_attribute("activation")->get_string_value() == "relu");
-  ASSERT_TRUE(gene1->get_attribute("aggregation")->get_string_value() == "sum");
+  GenomeConfig_ptr config = create_Config();
+  for (int i = 0; i < 100; i++)
+  {
+    NodeGene gene(i, *config);
+    ASSERT_EQ(gene.key, i);
+    ASSERT_TRUE(gene.bias <= 10.F && gene.bias >= -10.F);
+    ASSERT_TRUE(gene.response <= 20.F && gene.response >= -20.F);
+    ASSERT_TRUE(gene.activation == relu_act || gene.activation == linear_act);
+    ASSERT_TRUE(gene.aggregation == valid_aggregations::sum || gene.aggregation == valid_aggregations::max);
+    // the time constant isn't configured so it is fixed at 1
+    ASSERT_EQ(gene.time_constant, 1.F);
+  }
 }
 
-TEST(GENE, MutateTest)
+TEST(NODEGENE, MutateTest)
 {
-  Gene_ptr gene1 = create_MutableNode3();
-  Gene_ptr gene1_copy = create_MutableNode3();
+  GenomeConfig_ptr config = create_Config();
+  NodeGene gene1 = create_Node1();
+  NodeGene gene1_copy = gene1;
   for (int i = 0; i < 10; i++)
   {
-    gene1->mutate();
+    gene1.mutate(*config);
   }
-  ASSERT_TRUE(gene1->get_attribute("bias")->get_float_value() <= 10.F);
-  ASSERT_TRUE(gene1->get_attribute("bias")->get_float_value() >= -10.F);
-  ASSERT_TRUE(gene1->get_attribute("bias")->get_float_value() != gene1_copy->get_attribute("bias")->get_float_value());
+  ASSERT_TRUE(gene1.bias <= 10.F);
+  ASSERT_TRUE(gene1.bias >= -10.F);
+  ASSERT_TRUE(gene1.bias != gene1_copy.bias);
 
-  ASSERT_TRUE(gene1->get_attribute("response")->get_float_value() <= 20.F);
-  ASSERT_TRUE(gene1->get_attribute("response")->get_float_value() >= -20);
-  ASSERT_TRUE(gene1->get_attribute("response")->get_float_value() != gene1_copy->get_attribute("response")->get_float_value());
-}
+  ASSERT_TRUE(gene1.response <= 20.F);
+  ASSERT_TRUE(gene1.response >= -20.F);
+  ASSERT_TRUE(gene1.response != gene1_copy.response);
 
-TEST(NODEGENE, IncorrectAttributeTest)
-{
-  FloatAttribute_ptr bias1 = std::make_shared<FloatAttribute>("notbias", 1.F, 0.1F, "gauss", 0.5F, 3.0F, 1.F, 1.F);
-  FloatAttribute_ptr resp1 = std::make_shared<FloatAttribute>("notresponse", 1.F, 0.F, "gauss", 0.5F, 3.0F, 1.F, 1.F);
-  std::vector<Attribute_ptr> gene1_attributes;
-  gene1_attributes.push_back(bias1);
-  gene1_attributes.push_back(resp1);
-  ASSERT_THROW(NodeGene gene1(1, gene1_attributes), std::invalid_argument);
+  ASSERT_TRUE(gene1.activation == relu_act || gene1.activation == linear_act);
+  ASSERT_TRUE(gene1.aggregation == valid_aggregations::sum || gene1.aggregation == valid_aggregations::max);
+  ASSERT_EQ(gene1.time_constant, 1.F);
 }
 
 TEST(NODEGENE, ZeroDistanceTest)
 {
   // Create First Node
-  NodeGene_ptr gene1 = create_Node1();
+  NodeGene gene1 = create_Node1();
 
   // Create Second Node
-  NodeGene_ptr gene2 = create_Node1();
+  NodeGene gene2 = create_Node1();
 
-  // Check Distance Between Two *almost* identical genes is 0
-  ASSERT_EQ(gene1->distance(gene2), 0);
+  // Check Distance Between Two identical genes is 0
+  ASSERT_EQ(gene1.distance(gene2), 0);
 
-  // Check Distance Between identical genes is 0
-  ASSERT_EQ(gene1->distance(gene1), 0);
+  // Check Distance Between the same gene is 0
+  ASSERT_EQ(gene1.distance(gene1), 0);
 }
 
 TEST(NODEGENE, NonZeroDistanceTest)
 {
   // Create First Node
-  NodeGene_ptr gene1 = create_Node1();
+  NodeGene gene1 = create_Node1();
 
   // Create Second Node
-  NodeGene_ptr gene2 = create_Node2();
+  NodeGene gene2 = create_Node2();
 
   // Check distance between genes is calculated correctly and is positive
-  ASSERT_EQ(gene1->distance(gene2), 29);
-  ASSERT_TRUE(gene1->distance(gene2) >= 0);
+  ASSERT_EQ(gene1.distance(gene2), 29);
+  ASSERT_TRUE(gene1.distance(gene2) >= 0);
+
+  ASSERT_EQ(gene2.distance(gene1), 29);
+  ASSERT_TRUE(gene2.distance(gene1) >= 0);
 
-  ASSERT_EQ(gene2->distance(gene1), 29);
-  ASSERT_TRUE(gene2->distance(gene1) >= 0);
+  // time constants only differ between CTRNN nodes
+  NodeGene gene3(1, 1.F, 2.F, relu_act, valid_aggregations::sum, 3.F);
+  ASSERT_EQ(gene1.distance(gene3, 0.5F), 1.F);
 }
 
 TEST(NODEGENE, CrossoverTest)
 {
   // Create First Node
-  NodeGene_ptr gene1 = create_Node1();
+  NodeGene gene1 = create_Node1();
 
   // Create Second Node
-  NodeGene_ptr gene2 = create_Node2();
+  NodeGene gene2 = create_Node2();
 
   // Crosover Two Nodes
-  NodeGene_ptr gene3 = gene1->crossover(gene2);
+  NodeGene gene3 = gene1.crossover(gene2);
 
   // Check that crosover node contains attributed from either parent gene
-  ASSERT_TRUE((gene3->get_attribute("bias")->get_float_value() == 1.F) ||
-              (gene3->get_attribute("bias")->get_float_value() == 10.F));
-  ASSERT_TRUE((gene3->get_attribute("response")->get_float_value() == 2.F) ||
-              (gene3->get_attribute("response")->get_float_value() == 20.F));
-  ASSERT_TRUE((gene3->get_attribute("activation")->get_string_value() == "linear") ||
-              (gene3->get_attribute("activation")->get_string_value() == "relu"));
-  ASSERT_TRUE((gene3->get_attribute("aggregation")->get_string_value() == "sum") ||
-              (gene3->get_attribute("aggregation")->get_string_value() == "max"));
+  ASSERT_TRUE((gene3.bias == 1.F) || (gene3.bias == 10.F));
+  ASSERT_TRUE((gene3.response == 2.F) || (gene3.response == 20.F));
+  ASSERT_TRUE((gene3.activation == linear_act) || (gene3.activation == relu_act));
+  ASSERT_TRUE((gene3.aggregation == valid_aggregations::sum) || (gene3.aggregation == valid_aggregations::max));
+
+  // Only homologous genes can be crossed over
+  NodeGene gene4(2, 1.F, 2.F, relu_act, valid_aggregations::sum);
+  ASSERT_THROW(gene1.crossover(gene4), std::invalid_argument);
 }
 
 int main(int argc, char **argv)
 {
   testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
-}
\ No newline at end of file
+}
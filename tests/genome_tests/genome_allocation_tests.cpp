@@ -0,0 +1,88 @@
+#include "config_parser.h"
+#include "genome.h"
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Counts every heap allocation made by this test binary, which is why these tests
+// don't share an executable with the other genome tests
+static std::atomic<size_t> allocation_count{0};
+
+void *operator new(size_t size)
+{
+    allocation_count++;
+    void *p = std::malloc(size ? size : 1);
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete[](void *p, size_t) noexcept { std::free(p); }
+
+TEST(GENOMEALLOCATIONTEST, ForwardSpanTest)
+{
+    ConfigParser_ptr config = std::make_shared<ConfigParser>("config/ValidConfigDirect.cfg");
+    Genome_ptr genome = std::make_shared<Genome>(1, config);
+    genome->activate();
+
+    std::vector<float> inputs = {0.5F, -1.5F};
+    std::vector<float> outputs(genome->get_num_outputs());
+    std::vector<float> wrong_size(1);
+    ASSERT_THROW(genome->forward(std::span<const float>(inputs), std::span<float>(wrong_size)), std::invalid_argument);
+
+    // the first call sizes the scratch buffers
+    genome->forward(std::span<const float>(inputs), std::span<float>(outputs));
+    ASSERT_EQ(outputs, genome->forward(inputs));
+
+    const size_t allocations_before = allocation_count;
+    for (int i = 0; i < 100; i++)
+    {
+        inputs[0] = 0.01F * i;
+        genome->forward(std::span<const float>(inputs), std::span<float>(outputs));
+    }
+    ASSERT_EQ(allocation_count, allocations_before);
+}
+
+TEST(GENOMEALLOCATIONTEST, SharedConfigTest)
+{
+    ConfigParser_ptr config = std::make_shared<ConfigParser>("config/MutateNodeAdd.cfg");
+    GenomeConfig_ptr genome_config = std::make_shared<GenomeConfig>(config);
+    Genome_ptr parent1 = std::make_shared<Genome>(1, genome_config);
+    Genome_ptr parent2 = std::make_shared<Genome>(2, genome_config);
+    parent2->mutate();
+    const int num_children = 1000;
+
+    // Children of a population only point to the shared config
+    std::vector<Genome_ptr> children;
+    children.reserve(num_children);
+    size_t start_count = allocation_count;
+    for (int i = 0; i < num_children; i++)
+    {
+        children.push_back(std::make_shared<Genome>(i + 3, parent1, parent2, genome_config));
+    }
+    const size_t shared_allocations = allocation_count - start_count;
+    ASSERT_EQ(genome_config.use_count(), num_children + 3);
+    children.clear();
+
+    // Parsing the config for every child costs far more than the crossover itself
+    start_count = allocation_count;
+    for (int i = 0; i < num_children; i++)
+    {
+        children.push_back(std::make_shared<Genome>(i + 3, parent1, parent2, config));
+    }
+    const size_t parsed_allocations = allocation_count - start_count;
+    ASSERT_LT(shared_allocations * 4, parsed_allocations);
+}
+
+int main(int argc, char **argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
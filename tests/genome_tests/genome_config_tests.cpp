@@ -25,6 +25,11 @@ TEST(GENOMECONFIG, CorrectConversionTest)
     std::set<std::string> act_opt;
     act_opt.insert("relu");
     ASSERT_EQ(genome_config->activation_options, act_opt);
+    ASSERT_EQ(genome_config->activation_precision, valid_precisions::exact);
+    ASSERT_EQ(genome_config->feed_forward, true);
+    // time constants are fixed at 1 when they aren't configured
+    ASSERT_FLOAT_EQ(genome_config->time_constant_init_mean, 1.0);
+    ASSERT_FLOAT_EQ(genome_config->time_constant_mutate_rate, 0.0);
 
     ASSERT_EQ(genome_config->aggregation_default, "sum");
     ASSERT_FLOAT_EQ(genome_config->aggregation_mutate_rate, 0.0);
@@ -80,6 +85,13 @@ TEST(GENOMECONFIG, CorrectConversionTest)
     ASSERT_FLOAT_EQ(genome_config->weight_replace_rate, 0.1);
 }
 
+TEST(GENOMECONFIG, ActivationPrecisionTest)
+{
+    ConfigParser_ptr config = std::make_shared<ConfigParser>("config/ActivationPrecision.cfg");
+    GenomeConfig_ptr genome_config = std::make_shared<GenomeConfig>(config);
+    ASSERT_EQ(genome_config->activation_precision, valid_precisions::lut);
+}
+
 int main(int argc, char **argv)
 {
     testing::InitGoogleTest(&argc, argv);
@@ -2,6 +2,8 @@
 #include "genome.h"
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <thread>
 
 TEST(GENOMETEST, ConstructionTestFullDirect)
 {
@@ -93,6 +95,261 @@ TEST(GENOMETEST, ForwardRepeatabilityTest)
         }
     }
 }
+TEST(GENOMETEST, ForwardValueTest)
+{
+    // Every weight, bias and response is pinned to 2 with relu/sum nodes
+    ConfigParser_ptr config = std::make_shared<ConfigParser>("config/ForwardTest.cfg");
+    Genome_ptr genome = std::make_shared<Genome>(1, config);
+    genome->activate();
+
+    std::vector<float> out = genome->forward({1.0F, 2.0F});
+    ASSERT_EQ(out.size(), 4);
+    // hidden = 2 + 2 * (2 * 1 + 2 * 2) = 14
+    // output = 2 + 2 * (2 * 1 + 2 * 2 + 3 * (2 * 14)) = 182
+    for (float o : out)
+    {
+        ASSERT_FLOAT_EQ(o, 182.0F);
+    }
+
+    FeedForwardNetwork_ptr network = genome->get_network();
+    ASSERT_EQ(network->num_inputs, 2);
+    ASSERT_EQ(network->num_outputs, 4);
+    ASSERT_EQ(network->num_nodes, 9);
+    ASSERT_EQ(network->edge_sources.size(), (2 * (4 + 3)) + (3 * 4));
+    // hidden nodes only read inputs, outputs read the hidden nodes
+    ASSERT_EQ(network->get_num_levels(), 2);
+    ASSERT_EQ(network->level_offsets, std::vector<int>({0, 3, 7}));
+}
+TEST(GENOMETEST, NetworkLevelTest)
+{
+    FeedForwardNetwork network(2);
+    ASSERT_THROW(network.add_node(0.0F, 1.0F, linear_act, valid_aggregations::sum), std::runtime_error);
+
+    network.add_level();
+    network.add_node(1.0F, 1.0F, linear_act, valid_aggregations::sum);
+    network.add_edge(0, 1.0F);
+    network.add_node(0.0F, 1.0F, relu_act, valid_aggregations::sum);
+    network.add_edge(1, -1.0F);
+    // nodes of the same level can't feed each other
+    ASSERT_THROW(network.add_edge(2, 1.0F), std::invalid_argument);
+
+    network.add_level();
+    network.add_node(0.0F, 2.0F, linear_act, valid_aggregations::sum);
+    network.add_edge(2, 1.0F);
+    network.add_edge(3, 1.0F);
+    network.add_output(4);
+
+    // 2 * ((1 + 3) + relu(-4))
+    ASSERT_FLOAT_EQ(network.forward({3.0F, 4.0F})[0], 8.0F);
+    // 2 * ((1 - 3) + relu(4))
+    ASSERT_FLOAT_EQ(network.forward({-3.0F, -4.0F})[0], 4.0F);
+}
+TEST(GENOMETEST, ForwardNotActivatedTest)
+{
+    ConfigParser_ptr config = std::make_shared<ConfigParser>("config/ForwardTest.cfg");
+    Genome_ptr genome = std::make_shared<Genome>(1, config);
+
+    ASSERT_THROW(genome->forward({1.0F, 2.0F}), std::runtime_error);
+    genome->activate();
+    ASSERT_THROW(genome->forward({1.0F}), std::invalid_argument);
+}
+TEST(GENOMETEST, RecurrentForwardTest)
+{
+    ConfigParser_ptr config = std::make_shared<ConfigParser>("config/RecurrentForwardTest.cfg");
+    Genome_ptr genome = std::make_shared<Genome>(1, config);
+    genome->activate();
+    ASSERT_THROW(genome->get_network(), std::runtime_error);
+    ASSERT_EQ(genome->get_recurrent_network()->num_nodes, 9);
+
+    // step 1: hidden nodes start at 0, hidden = 2 + 2 * (2 * 1 + 2 * 2) = 14
+    // output = 2 + 2 * (2 * 1 + 2 * 2 + 3 * (2 * 0)) = 14
+    for (float o : genome->forward({1.0F, 2.0F}))
+    {
+        ASSERT_FLOAT_EQ(o, 14.0F);
+    }
+    // step 2: the outputs see the hidden values of step 1, as in the feed forward network
+    for (float o : genome->forward({1.0F, 2.0F}))
+    {
+        ASSERT_FLOAT_EQ(o, 182.0F);
+    }
+    genome->reset();
+    for (float o : genome->forward({1.0F, 2.0F}))
+    {
+        ASSERT_FLOAT_EQ(o, 14.0F);
+    }
+}
+TEST(GENOMETEST, ReactivateTest)
+{
+    ConfigParser_ptr config = std::make_shared<ConfigParser>("config/RecurrentForwardTest.cfg");
+    Genome_ptr genome = std::make_shared<Genome>(1, config);
+
+    // activating again keeps the network but starts it over from a fresh state
+    genome->activate();
+    RecurrentNetwork_ptr network = genome->get_recurrent_network();
+    std::vector<float> first = genome->forward({1.0F, 2.0F});
+    genome->forward({1.0F, 2.0F});
+    genome->activate();
+    ASSERT_EQ(genome->get_recurrent_network(), network);
+    ASSERT_EQ(genome->forward({1.0F, 2.0F}), first);
+    genome->activate();
+    ASSERT_EQ(genome->forward({1.0F, 2.0F}), first);
+
+    // genes modified directly are compiled again, input keys run -2, -1 so output 0 = 2 + 2 * (2 * 1 + 0 * 2)
+    genome->connections.update({-1, 0}, [](ConnectionGene &gene)
+                               { gene.weight = 0.0F; });
+    genome->activate();
+    ASSERT_NE(genome->get_recurrent_network(), network);
+    ASSERT_FLOAT_EQ(genome->forward({1.0F, 2.0F})[0], 6.0F);
+
+    // a node added directly becomes part of the network, output 1 = 2 + 2 * (2 * 2)
+    genome->nodes.insert(NodeGene(100, 0.0F, 1.0F, relu_act, valid_aggregations::sum));
+    genome->connections.insert(ConnectionGene({-1, 100}, 1.0F));
+    genome->connections.insert(ConnectionGene({100, 2}, 1.0F));
+    genome->connections.erase({-2, 1});
+    genome->activate();
+    ASSERT_EQ(genome->get_num_hidden(), 4);
+    ASSERT_EQ(genome->get_recurrent_network()->num_nodes, 10);
+    ASSERT_FLOAT_EQ(genome->forward({1.0F, 2.0F})[1], 10.0F);
+
+    // mutating after a direct modification starts from the modified genes
+    genome->mutate();
+    genome->activate();
+    ASSERT_EQ(genome->get_recurrent_network()->num_nodes, genome->get_num_nodes());
+    ASSERT_EQ(genome->forward({1.0F, 2.0F}).size(), 4);
+}
+
+TEST(GENOMETEST, ReactivateFeedForwardTest)
+{
+    // a hidden node spliced into a feed forward genome directly is placed in its topological order
+    ConfigParser_ptr config = std::make_shared<ConfigParser>("config/ValidConfigDirect.cfg");
+    Genome_ptr genome = std::make_shared<Genome>(1, config);
+    genome->activate();
+    std::vector<float> before = genome->forward({0.5F, -1.0F});
+    ASSERT_EQ(genome->forward({0.5F, -1.0F}), before);
+
+    genome->nodes.insert(NodeGene(100, 1000.0F, 1.0F, relu_act, valid_aggregations::sum));
+    genome->connections.insert(ConnectionGene({-1, 100}, 1.0F));
+    genome->connections.insert(ConnectionGene({100, 0}, 1.0F));
+    genome->activate();
+    ASSERT_TRUE(genome->reaches(-1, 100));
+    ASSERT_TRUE(genome->reaches(100, 0));
+    ASSERT_FALSE(genome->reaches(0, 100));
+    std::vector<float> after = genome->forward({0.5F, -1.0F});
+    ASSERT_NE(after[0], before[0]);
+    for (size_t o = 1; o < after.size(); o++)
+    {
+        ASSERT_EQ(after[o], before[o]);
+    }
+}
+
+TEST(GENOMETEST, RecurrentNetworkTest)
+{
+    // a single accumulating node: out(t) = in(t) + out(t - 1)
+    RecurrentNetwork network(1, 1);
+    network.add_node(0.0F, 1.0F, linear_act, valid_aggregations::sum);
+    network.add_edge(0, 1.0F);
+    network.add_edge(1, 1.0F);
+    network.add_output(1);
+    ASSERT_THROW(network.add_node(0.0F, 1.0F, linear_act, valid_aggregations::sum), std::runtime_error);
+    ASSERT_THROW(network.add_edge(2, 1.0F), std::invalid_argument);
+
+    ASSERT_FLOAT_EQ(network.forward({1.0F})[0], 1.0F);
+    ASSERT_FLOAT_EQ(network.forward({2.0F})[0], 3.0F);
+    ASSERT_FLOAT_EQ(network.forward({3.0F})[0], 6.0F);
+    network.reset();
+    ASSERT_FLOAT_EQ(network.forward({3.0F})[0], 3.0F);
+
+    // two sequences keep separate state
+    std::vector<float> out = network.forward_batch({1.0F, 10.0F}, 2);
+    ASSERT_EQ(out, std::vector<float>({1.0F, 10.0F}));
+    out = network.forward_batch({1.0F, -5.0F}, 2);
+    ASSERT_EQ(out, std::vector<float>({2.0F, 5.0F}));
+    ASSERT_EQ(network.get_batch_size(), 2);
+
+    // switching back to a single sequence starts from a fresh state
+    ASSERT_FLOAT_EQ(network.forward({4.0F})[0], 4.0F);
+}
+TEST(GENOMETEST, CTRNNIntegrationTest)
+{
+    // a single node without inputs: dy/dt = (1 - y) / 2, so y(t) = 1 - e^(-t / 2)
+    for (ctrnn_integrator integrator : {ctrnn_integrator::euler, ctrnn_integrator::rk4})
+    {
+        CTRNN network(1, 1, integrator);
+        network.add_node(1.0F, 1.0F, 2.0F, linear_act, valid_aggregations::sum);
+        network.add_output(1);
+        ASSERT_THROW(network.add_node(1.0F, 1.0F, 1.0F, linear_act, valid_aggregations::sum), std::runtime_error);
+
+        const float expected = 1.0F - std::exp(-0.5F);
+        if (integrator == ctrnn_integrator::euler)
+        {
+            ASSERT_NEAR(network.advance({0.0F}, 0.001F, 1000)[0], expected, 1e-3F);
+        }
+        else
+        {
+            ASSERT_NEAR(network.advance({0.0F}, 0.1F, 10)[0], expected, 1e-6F);
+        }
+        // the state carries over between calls
+        ASSERT_NEAR(network.advance({0.0F}, 0.01F, 100)[0], 1.0F - std::exp(-1.0F), 1e-3F);
+        network.reset();
+        ASSERT_FLOAT_EQ(network.get_state()[1], 0.0F);
+    }
+    CTRNN network(1, 1);
+    ASSERT_THROW(network.add_node(1.0F, 1.0F, 0.0F, linear_act, valid_aggregations::sum), std::invalid_argument);
+}
+TEST(GENOMETEST, CTRNNGenomeTest)
+{
+    ConfigParser_ptr config = std::make_shared<ConfigParser>("config/CTRNNTest.cfg");
+    Genome_ptr genome = std::make_shared<Genome>(1, config);
+    for (const NodeGene &node : genome->nodes)
+    {
+        ASSERT_FLOAT_EQ(node.time_constant, 0.5F);
+    }
+
+    CTRNN_ptr network = genome->create_ctrnn(ctrnn_integrator::rk4);
+    ASSERT_EQ(network->num_nodes, 9);
+    // without cycles the network settles on the feed forward result
+    std::vector<float> out = network->advance({1.0F, 2.0F}, 0.05F, 2000);
+    for (float o : out)
+    {
+        ASSERT_NEAR(o, 182.0F, 1e-3F);
+    }
+}
+TEST(GENOMETEST, ForwardBatchTest)
+{
+    ConfigParser_ptr config = std::make_shared<ConfigParser>("config/ValidConfigDirect.cfg");
+    Genome_ptr genome = std::make_shared<Genome>(1, config);
+    for (int i = 0; i < 10; i++)
+    {
+        genome->mutate();
+    }
+    genome->activate();
+
+    int batch_size = 16;
+    int num_inputs = genome->get_num_inputs();
+    int num_outputs = genome->get_num_outputs();
+    std::vector<float> batch_in;
+    for (int b = 0; b < batch_size; b++)
+    {
+        for (int in = 0; in < num_inputs; in++)
+        {
+            batch_in.push_back(0.25F * (b - 8) + in);
+        }
+    }
+
+    std::vector<float> batch_out = genome->forward_batch(batch_in, batch_size);
+    ASSERT_EQ(batch_out.size(), batch_size * num_outputs);
+    for (int b = 0; b < batch_size; b++)
+    {
+        std::vector<float> row(batch_in.begin() + b * num_inputs, batch_in.begin() + (b + 1) * num_inputs);
+        std::vector<float> out = genome->forward(row);
+        for (int o = 0; o < num_outputs; o++)
+        {
+            ASSERT_FLOAT_EQ(batch_out[b * num_outputs + o], out[o]);
+        }
+    }
+
+    ASSERT_THROW(genome->forward_batch(batch_in, batch_size + 1), std::invalid_argument);
+}
 TEST(GENOMETEST, MutateAddNodeTest)
 {
     ConfigParser_ptr config = std::make_shared<ConfigParser>("config/MutateNodeAdd.cfg");
@@ -140,6 +397,394 @@ TEST(GENOMETEST, MutateAddConnTest)
     ASSERT_EQ(after_conns - before_conns, 1);
 }
 
+TEST(GENOMETEST, MutateAddConnUniformTest)
+{
+    // 2 inputs -> 10 hidden -> 4 outputs, the 8 input -> output and 90 hidden -> hidden
+    // connections are possible and equally likely
+    ConfigParser_ptr config = std::make_shared<ConfigParser>("config/MutateConnAdd.cfg");
+    GenomeConfig_ptr genome_config = std::make_shared<GenomeConfig>(config);
+    const int num_genomes = 2000;
+    int direct = 0;
+    for (int i = 0; i < num_genomes; i++)
+    {
+        Genome_ptr genome = std::make_shared<Genome>(i, genome_config);
+        genome->mutate();
+        ASSERT_EQ(genome->get_num_connections(), 61);
+        for (int in_key = -1; in_key >= -2; in_key--)
+        {
+            for (int out_key = 0; out_key < 4; out_key++)
+            {
+                direct += genome->connections.count({in_key, out_key});
+            }
+        }
+    }
+    float direct_rate = static_cast<float>(direct) / num_genomes;
+    ASSERT_NEAR(direct_rate, 8.F / 98.F, 0.025F);
+}
+
+TEST(GENOMETEST, MutateDeleteNodeUniformTest)
+{
+    // every one of the 10 hidden nodes is equally likely to be deleted
+    ConfigParser_ptr config = std::make_shared<ConfigParser>("config/MutateNodeDel.cfg");
+    GenomeConfig_ptr genome_config = std::make_shared<GenomeConfig>(config);
+    const int num_genomes = 1000;
+    std::map<int, int> deleted;
+    for (int i = 0; i < num_genomes; i++)
+    {
+        Genome_ptr genome = std::make_shared<Genome>(i, genome_config);
+        genome->mutate();
+        for (int node_key = 4; node_key < 14; node_key++)
+        {
+            if (!genome->nodes.count(node_key))
+            {
+                deleted[node_key]++;
+            }
+        }
+    }
+    ASSERT_EQ(deleted.size(), 10);
+    for (std::pair<const int, int> &count : deleted)
+    {
+        ASSERT_NEAR(count.second, num_genomes / 10, 40);
+    }
+}
+
+TEST(GENOMETEST, MutateAddDeleteNodeTest)
+{
+    ConfigParser_ptr config = std::make_shared<ConfigParser>("config/MutateNodeAddDel.cfg");
+    GenomeConfig_ptr genome_config = std::make_shared<GenomeConfig>(config);
+    Genome_ptr genome = std::make_shared<Genome>(5, genome_config);
+    const int num_nodes = genome->get_num_nodes();
+
+    // a deleted node's key is never handed out again in a later generation
+    std::set<int> used_keys;
+    for (const NodeGene &node : genome->nodes)
+    {
+        used_keys.insert(node.key);
+    }
+    for (int i = 0; i < 100; i++)
+    {
+        std::set<int> before_keys;
+        for (const NodeGene &node : genome->nodes)
+        {
+            before_keys.insert(node.key);
+        }
+        genome_config->innovation_tracker->next_generation();
+        genome->mutate();
+        ASSERT_EQ(genome->get_num_nodes(), num_nodes);
+        for (const NodeGene &node : genome->nodes)
+        {
+            if (!before_keys.count(node.key))
+            {
+                ASSERT_FALSE(used_keys.count(node.key));
+                used_keys.insert(node.key);
+            }
+        }
+    }
+}
+
+TEST(GENOMETEST, MutateStructureTest)
+{
+    ConfigParser_ptr config = std::make_shared<ConfigParser>("config/MutateStructure.cfg");
+    Genome_ptr genome = std::make_shared<Genome>(5, config);
+    for (int i = 0; i < 200; i++)
+    {
+        genome->mutate();
+
+        // deleted nodes take every connection into and out of them along
+        std::map<int, int> pending_inputs;
+        for (const NodeGene &node : genome->nodes)
+        {
+            pending_inputs[node.key] = 0;
+        }
+        for (const ConnectionGene &conn : genome->connections)
+        {
+            ASSERT_TRUE(genome->nodes.count(conn.key.first));
+            ASSERT_TRUE(genome->nodes.count(conn.key.second));
+            pending_inputs[conn.key.second]++;
+        }
+
+        // added connections never close a cycle, enabled or not
+        std::vector<int> ready;
+        for (std::pair<const int, int> &pending : pending_inputs)
+        {
+            if (pending.second == 0)
+            {
+                ready.push_back(pending.first);
+            }
+        }
+        size_t ordered = 0;
+        while (!ready.empty())
+        {
+            int node_key = ready.back();
+            ready.pop_back();
+            ordered++;
+            for (const ConnectionGene &conn : genome->connections)
+            {
+                if (conn.key.first == node_key && --pending_inputs[conn.key.second] == 0)
+                {
+                    ready.push_back(conn.key.second);
+                }
+            }
+        }
+        ASSERT_EQ(ordered, genome->nodes.size());
+
+        genome->activate();
+        ASSERT_EQ(genome->forward({1.0F, 1.0F}).size(), 4);
+        // an unchanged genome keeps its network
+        FeedForwardNetwork_ptr network = genome->get_network();
+        genome->activate();
+        ASSERT_EQ(genome->get_network(), network);
+    }
+}
+
+TEST(GENOMETEST, ReachabilityTest)
+{
+    ConfigParser_ptr config = std::make_shared<ConfigParser>("config/MutateStructure.cfg");
+    Genome_ptr genome = std::make_shared<Genome>(5, config);
+    int dead_nodes = 0;
+    for (int i = 0; i < 100; i++)
+    {
+        genome->mutate();
+
+        // the matrix kept by the mutations matches a search over the connections
+        for (const NodeGene &from : genome->nodes)
+        {
+            std::set<int> reached;
+            std::vector<int> stack = {from.key};
+            while (!stack.empty())
+            {
+                int curr = stack.back();
+                stack.pop_back();
+                for (const ConnectionGene &conn : genome->connections)
+                {
+                    if (conn.key.first == curr && reached.insert(conn.key.second).second)
+                    {
+                        stack.push_back(conn.key.second);
+                    }
+                }
+            }
+            bool reaches_output = from.key >= 0 && from.key < 4;
+            for (const NodeGene &to : genome->nodes)
+            {
+                ASSERT_EQ(genome->reaches(from.key, to.key), reached.count(to.key) == 1);
+                reaches_output = reaches_output || (to.key >= 0 && to.key < 4 && reached.count(to.key));
+            }
+            ASSERT_EQ(genome->reaches_output(from.key), reaches_output);
+            dead_nodes += !reaches_output;
+        }
+    }
+    // deleted connections leave nodes behind that are pruned from the network
+    ASSERT_GT(dead_nodes, 0);
+}
+
+TEST(GENOMETEST, InnovationTest)
+{
+    // a single connection (-1, 0) that every genome splits
+    ConfigParser_ptr config = std::make_shared<ConfigParser>("config/InnovationConfig.cfg");
+    GenomeConfig_ptr genome_config = std::make_shared<GenomeConfig>(config);
+    Genome_ptr genome1 = std::make_shared<Genome>(1, genome_config);
+    Genome_ptr genome2 = std::make_shared<Genome>(2, genome_config);
+    genome1->mutate();
+    genome2->mutate();
+
+    // the same split in the same generation is the same innovation
+    ASSERT_EQ(genome1->get_num_nodes(), 3);
+    ASSERT_EQ(genome2->get_num_nodes(), 3);
+    ASSERT_TRUE(std::equal(genome1->nodes.begin(), genome1->nodes.end(), genome2->nodes.begin(),
+                           [](const NodeGene &a, const NodeGene &b)
+                           { return a.key == b.key; }));
+    ASSERT_TRUE(std::equal(genome1->connections.begin(), genome1->connections.end(), genome2->connections.begin(),
+                           [](const ConnectionGene &a, const ConnectionGene &b)
+                           { return a.key == b.key; }));
+
+    // in the next generation the split is a new innovation
+    genome_config->innovation_tracker->next_generation();
+    Genome_ptr genome3 = std::make_shared<Genome>(3, genome_config);
+    genome3->mutate();
+    ASSERT_EQ(genome3->get_num_nodes(), 3);
+    ASSERT_NE((genome3->nodes.begin() + 2)->key, (genome1->nodes.begin() + 2)->key);
+
+    // a genome parsing its own config has a history of its own and can't be crossed with the others
+    Genome_ptr standalone = std::make_shared<Genome>(4, config);
+    ASSERT_THROW(std::make_shared<Genome>(5, genome1, standalone, genome_config), std::invalid_argument);
+    ASSERT_THROW(std::make_shared<Genome>(5, standalone, standalone, genome_config), std::invalid_argument);
+
+    // a child parsing its own config keeps the innovation tracker of its parents
+    Genome_ptr child = std::make_shared<Genome>(6, genome1, genome2, config);
+    ASSERT_NO_THROW(std::make_shared<Genome>(7, child, genome3, genome_config));
+}
+
+TEST(GENOMETEST, InnovationTrackerThreadTest)
+{
+    InnovationTracker tracker(10);
+    const int num_threads = 8;
+    const int num_splits = 200;
+
+    // every thread splits the same connections and asks for fresh keys
+    std::vector<std::vector<int>> split_keys(num_threads);
+    std::vector<std::vector<int>> new_keys(num_threads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < num_threads; t++)
+    {
+        threads.emplace_back([&, t]()
+                             {
+            for (int i = 0; i < num_splits; i++)
+            {
+                split_keys[t].push_back(tracker.split_node_key({-1, i}));
+                new_keys[t].push_back(tracker.new_node_key());
+            } });
+    }
+    for (std::thread &thread : threads)
+    {
+        thread.join();
+    }
+
+    std::set<int> keys;
+    for (int t = 0; t < num_threads; t++)
+    {
+        ASSERT_EQ(split_keys[t], split_keys[0]);
+        keys.insert(new_keys[t].begin(), new_keys[t].end());
+    }
+    keys.insert(split_keys[0].begin(), split_keys[0].end());
+    ASSERT_EQ(keys.size(), num_threads * num_splits + num_splits);
+    ASSERT_GE(*keys.begin(), 10);
+}
+
+TEST(GENOMETEST, RecurrentMutateConnAddTest)
+{
+    // inputs are already connected to the only output, so the only new connection
+    // a recurrent genome can make is the output feeding itself
+    ConfigParser_ptr config = std::make_shared<ConfigParser>("config/RecurrentMutateConnAdd.cfg");
+    Genome_ptr genome = std::make_shared<Genome>(5, config);
+    ASSERT_EQ(genome->get_num_connections(), 2);
+    genome->mutate();
+    ASSERT_EQ(genome->get_num_connections(), 3);
+    ASSERT_TRUE(genome->connections.count({0, 0}));
+}
+
+TEST(GENOMETEST, GeneVectorTest)
+{
+    GeneVector<ConnectionGene> genes;
+    genes.assign({ConnectionGene({2, 0}, 1.0F), ConnectionGene({-1, 0}, 2.0F), ConnectionGene({-2, 1}, 3.0F)});
+    ASSERT_EQ(genes.size(), 3);
+    // genes are kept sorted by key
+    ASSERT_TRUE(std::is_sorted(genes.begin(), genes.end()));
+    ASSERT_EQ(genes.at({-1, 0}).weight, 2.0F);
+    ASSERT_FALSE(genes.count({0, 2}));
+    ASSERT_THROW(genes.at({0, 2}), std::invalid_argument);
+
+    genes.insert(ConnectionGene({0, 1}, 4.0F));
+    genes.insert(ConnectionGene({-1, 0}, 5.0F));
+    ASSERT_EQ(genes.size(), 4);
+    ASSERT_TRUE(std::is_sorted(genes.begin(), genes.end()));
+    ASSERT_EQ(genes.at({-1, 0}).weight, 5.0F);
+    ASSERT_EQ(genes.lower_bound({-1, 1})->key, std::make_pair(0, 1));
+    ASSERT_EQ(genes.lower_bound({-3, 0})->key, std::make_pair(-2, 1));
+    ASSERT_TRUE(genes.lower_bound({2, 1}) == genes.end());
+
+    ASSERT_EQ(genes.erase({0, 1}), 1);
+    ASSERT_EQ(genes.erase({0, 1}), 0);
+    ASSERT_EQ(genes.erase_if([](const ConnectionGene &gene)
+                             { return gene.key.second == 0; }),
+              2);
+    ASSERT_EQ(genes.size(), 1);
+
+    ASSERT_THROW(genes.push_back(ConnectionGene({-3, 0}, 1.0F)), std::invalid_argument);
+    ASSERT_THROW(genes.assign({ConnectionGene({1, 0}, 1.0F), ConnectionGene({1, 0}, 2.0F)}), std::invalid_argument);
+}
+
+TEST(GENOMETEST, GeneVectorCopyOnWriteTest)
+{
+    const int num_genes = 5 * GeneVector<ConnectionGene>::block_size;
+    std::vector<ConnectionGene> gene_list;
+    for (int i = 0; i < num_genes; i++)
+    {
+        gene_list.push_back(ConnectionGene({-1, i}, static_cast<float>(i)));
+    }
+    GeneVector<ConnectionGene> parent;
+    parent.assign(gene_list);
+    ASSERT_EQ(parent.num_blocks(), 5);
+
+    // copies share every block
+    GeneVector<ConnectionGene> child = parent;
+    ASSERT_EQ(child.shared_blocks(parent), 5);
+
+    // updates that change nothing keep the blocks shared
+    child.update_blocks([](std::span<ConnectionGene> genes)
+                        { ASSERT_LE(genes.size(), 2 * GeneVector<ConnectionGene>::block_size); });
+    ASSERT_EQ(child.shared_blocks(parent), 5);
+
+    // only the block of a changed gene is copied
+    child.update({-1, 40}, [](ConnectionGene &gene)
+                 { gene.weight = -1.0F; });
+    ASSERT_EQ(child.shared_blocks(parent), 4);
+    ASSERT_EQ(child.at({-1, 40}).weight, -1.0F);
+    ASSERT_EQ(parent.at({-1, 40}).weight, 40.0F);
+
+    child.update_blocks([](std::span<ConnectionGene> genes)
+                        {
+                            for (ConnectionGene &gene : genes)
+                            {
+                                if (gene.key.second == 100)
+                                {
+                                    gene.weight = 0.0F;
+                                }
+                            } });
+    ASSERT_EQ(child.shared_blocks(parent), 3);
+    ASSERT_EQ(child.at({-1, 100}).weight, 0.0F);
+    ASSERT_EQ(parent.at({-1, 100}).weight, 100.0F);
+
+    // derived genes share the blocks they leave unchanged
+    GeneVector<ConnectionGene> derived;
+    derived.assign_derived(parent, [](const ConnectionGene &gene)
+                           { return gene.key.second == 0 ? ConnectionGene(gene.key, 5.0F) : gene; });
+    ASSERT_EQ(derived.shared_blocks(parent), 4);
+    ASSERT_EQ(derived.size(), parent.size());
+    ASSERT_TRUE(std::is_sorted(derived.begin(), derived.end()));
+
+    // erasing and inserting only touch their block and keep the genes sorted
+    ASSERT_EQ(child.erase_if([](const ConnectionGene &gene)
+                             { return gene.key.second >= 150; }),
+              10);
+    ASSERT_EQ(child.shared_blocks(parent), 2);
+    for (int i = 0; i < 2 * static_cast<int>(GeneVector<ConnectionGene>::block_size); i++)
+    {
+        child.insert(ConnectionGene({-2, i}, 1.0F));
+    }
+    ASSERT_EQ(child.size(), num_genes - 10 + 2 * GeneVector<ConnectionGene>::block_size);
+    ASSERT_TRUE(std::is_sorted(child.begin(), child.end()));
+    ASSERT_EQ(std::distance(child.begin(), child.end()), child.size());
+    ASSERT_EQ((child.begin() + 6)->key, std::make_pair(-2, 6));
+    ASSERT_EQ((child.begin() + 70)->key, std::make_pair(-1, 6));
+    ASSERT_EQ(parent.size(), num_genes);
+}
+
+TEST(GENOMETEST, CrossoverDistanceTest)
+{
+    ConfigParser_ptr config = std::make_shared<ConfigParser>("config/MutateNodeAdd.cfg");
+    GenomeConfig_ptr genome_config = std::make_shared<GenomeConfig>(config);
+    Genome_ptr parent1 = std::make_shared<Genome>(1, genome_config);
+    Genome_ptr parent2 = std::make_shared<Genome>(2, genome_config);
+    parent1->fitness = 1.0F;
+    parent2->mutate();
+
+    ASSERT_FLOAT_EQ(parent1->distance(parent1), 0.0F);
+    ASSERT_FLOAT_EQ(parent1->distance(parent2), parent2->distance(parent1));
+
+    // the child inherits the genes of the fitter parent, each from either parent where both have it
+    Genome_ptr child = std::make_shared<Genome>(3, parent1, parent2, config);
+    ASSERT_EQ(child->get_num_nodes(), parent1->get_num_nodes());
+    ASSERT_EQ(child->get_num_connections(), parent1->get_num_connections());
+    ASSERT_TRUE(std::is_sorted(child->nodes.begin(), child->nodes.end()));
+    ASSERT_TRUE(std::is_sorted(child->connections.begin(), child->connections.end()));
+    for (const ConnectionGene &conn : child->connections)
+    {
+        GeneVector<ConnectionGene>::const_iterator other = parent2->connections.find(conn.key);
+        ASSERT_TRUE(conn.weight == parent1->connections.at(conn.key).weight ||
+                    (other != parent2->connections.end() && conn.weight == other->weight));
+    }
+}
+
 TEST(GENOMETEST, ConstructionTest)
 {
     ConfigParser_ptr config = std::make_shared<ConfigParser>("config/MyConfig.cfg");
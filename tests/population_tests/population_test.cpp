@@ -1,8 +1,15 @@
 #include "config_parser.h"
 #include "population.h"
 
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
 #include <gtest/gtest.h>
 
+// copying a genome has to name the resource of the copy, so no copy outlives the arena it points into
+static_assert(!std::is_copy_constructible_v<Genome>);
+static_assert(!std::is_copy_assignable_v<Genome>);
+
 TEST(POPULATIONTEST, ConstructionTest)
 {
     ConfigParser_ptr config = std::make_shared<ConfigParser>("config/ValidConfig.cfg");
@@ -202,9 +209,79 @@ TEST(POPULATIONTEST, ReproductionTest)
         p.species_set->speciate(p.population, generation);
     }
 
+    // The stagnant founder is pruned, leaving the two species that split off of it
     ASSERT_EQ(p.species_set->species.size(), 2);
-    ASSERT_EQ(p.species_set->species[3]->members.size(), 10);
-    ASSERT_EQ(p.species_set->species[4]->members.size(), 31);
+    ASSERT_TRUE(p.species_set->species.count(2));
+    ASSERT_TRUE(p.species_set->species.count(3));
+    ASSERT_EQ(p.species_set->species[2]->members.size(), 10);
+    ASSERT_EQ(p.species_set->species[3]->members.size(), 31);
+}
+
+TEST(POPULATIONTEST, GenomeArenaTest)
+{
+    GenomeArena arena(256);
+
+    // Allocations are aligned and don't overlap
+    void *a = arena.allocate(100, 8);
+    void *b = arena.allocate(4, 64);
+    ASSERT_EQ(reinterpret_cast<uintptr_t>(b) % 64, 0);
+    ASSERT_TRUE(static_cast<char *>(b) >= static_cast<char *>(a) + 100);
+    ASSERT_EQ(arena.bytes_allocated(), 104);
+
+    // Requests larger than a slab get a slab of their own
+    void *large = arena.allocate(1000, 8);
+    ASSERT_TRUE(large != nullptr);
+    size_t reserved = arena.bytes_reserved();
+    ASSERT_TRUE(reserved >= 1256);
+
+    // Reset recycles the slabs instead of allocating new ones
+    arena.reset();
+    ASSERT_EQ(arena.bytes_allocated(), 0);
+    ASSERT_EQ(arena.allocate(100, 8), a);
+    ASSERT_EQ(arena.bytes_reserved(), reserved);
+}
+
+TEST(POPULATIONTEST, ArenaReproductionTest)
+{
+    ConfigParser_ptr config = std::make_shared<ConfigParser>("config/ArenaConfig.cfg");
+    Population p = Population(config);
+    ASSERT_TRUE(p.config->genome_arena);
+    ASSERT_EQ(p.population.size(), 40);
+    ASSERT_EQ(p.arenas.size(), 1);
+
+    Genome_ptr kept;
+    for (int generation = 0; generation < 10; generation++)
+    {
+        for (std::pair<const int, Genome_ptr> git : p.population)
+        {
+            git.second->fitness = git.first;
+        }
+        Genome_ptr best = p.population.rbegin()->second;
+        std::map<int, Genome_ptr> new_population = p.reproduce(generation);
+
+        // The best genome survives as an elite copy with identical genes
+        ASSERT_TRUE(new_population.count(best->key));
+        Genome_ptr elite = new_population[best->key];
+        ASSERT_NE(elite.get(), best.get());
+        ASSERT_EQ(elite->nodes.size(), best->nodes.size());
+        ASSERT_EQ(elite->connections.size(), best->connections.size());
+        ASSERT_TRUE(std::equal(elite->connections.begin(), elite->connections.end(), best->connections.begin(),
+                               [](const ConnectionGene &c1, const ConnectionGene &c2)
+                               { return c1.key == c2.key && c1.weight == c2.weight; }));
+
+        // Holding on to one genome keeps its generation's arena from being recycled
+        if (generation == 2)
+        {
+            kept = best;
+        }
+
+        p.population = new_population;
+        p.species_set->speciate(p.population, generation);
+    }
+    // The current and the previous generation alternate, plus the arena kept alive
+    ASSERT_TRUE(p.arenas.size() <= 3);
+    ASSERT_NO_THROW(kept->activate());
+    ASSERT_EQ(kept->forward({1.F, 1.F}).size(), kept->get_num_outputs());
 }
 
 int main(int argc, char **argv)